@@ -11,22 +11,34 @@ The a* algorithem is run between the start and end point, that are connected to
 The a* algorithem is run for every entry, exit point combination, and than the shortest path is chosen.
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdbool.h>
-
-///////////////////////////////////////////////////////////////////////////////////////////////
-// ENUMS
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-enum Sides { // declare the directions
-    DIAGONAL_LEFT,
-    DIAGONAL_RIGHT,
-    STRAIGHT
-};
-
-void fns(enum Sides *currentDir, int direction) {
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "maze.h"
+
+#define TILE_SHIFT 6
+#define TILE_SIZE (1 << TILE_SHIFT) // 64 x 64 cells, 4 KiB per tile
+#define L2_CACHE_SIZE (1 << 18) // a typical L2 cache, 256 KiB
+#define BFS_ENGINE_MAX_CELLS (1 << 16) // smaller maps are searched cell by cell, the graph costs more than it saves
+#define BFS_ENGINE_MIN_JUNCTIONS_PERCENT 10 // with more decision points the corridors are too short for the graph
+#define CELL_QUEUE_MIN_CAPACITY 1024
+#define BENCH_MAX_CELLS 10000000 // the biggest benchmarked maze, the graph of an open maze of 10^8 cells does not fit in the memory
+#define NO_ENTRY_SIDE 0xFF // the border position is closed
+
+static void fns(enum Sides *currentDir, int direction) {
     // Calculate the new direction based on left or right.
     if (direction == 0) 
         *currentDir= (*currentDir +2) % 3;
@@ -38,51 +50,103 @@ void fns(enum Sides *currentDir, int direction) {
 // STRUCTURES
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+struct Perimeter {
+    EntryPointsArray entries; // in the order of the border positions
+    unsigned char *sides; // entry side of every border position (top row, right column, bottom row, left column), NO_ENTRY_SIDE if closed
+    _Atomic uint64_t *jumps; // end of the corridor entered throw every cell and side (3 per cell, the same layout as the cells), 0 until a walk without output follows it, NULL if it could not be allocated
+};
+
+typedef struct {
+    Point* points;
+    int pointsCount;
+} Path;
+
 typedef struct {
-    int row;
-    int col;
-} Point;
+    Point *points; // ring buffer, the capacity is a power of two
+    int capacity;
+    int head; // index of the first point
+    int count;
+} CellQueue;
 
 typedef struct {
-  int rows;
-  int cols;
-  unsigned char *cells;
-} Map;
+    Map *map;
+    int firstRow;
+    int lastRow;
+    bool storeMoves;
+    MazePointsArray corridors; // corridors starting in the rows of the band
+    enum MazeStatus status;
+} GraphBand;
 
 typedef struct {
-    int row;
-    int col;
-    enum Sides entrySide;
-} EntryPoint;
+    long long distance; // the costs are up to 255 per cell, the sums do not fit into an int on big maps
+    int node;
+} RouteHeapItem; // item of the binary heaps of the a* and of the route search
 
 typedef struct {
-    EntryPoint *entryPoints;
-    int entryPointsCount;
-} EntryPointsArray;
+    Point point; // start point of the maze point
+    int idx; // index of the maze point
+} ConectionEntry;
 
 typedef struct {
+    MazePointsArray *graph;
     Point startPoint;
-    Point endPoint;
-    enum Sides currentDir;
-    int distance;
-    enum Sides *moveThrowFaces;
-    bool finished;
-} MazePoint;
+    int startCost; // cost of the entry point, the routes start with it
+    int nodesCount; // every start point of the graph is a node
+    int *firstCorridorOfNode; // corridors of the node are firstCorridorOfNode[node] ... firstCorridorOfNode[node+1]-1
+    int *endNodeOfCorridor; // -1 if the corridor leaves the map or the end point has no corridors, -2 if it leaves the same cell as the previous one
+    bool *bannedCorridors;
+    bool *bannedNodes;
+    long long *distances;
+    int *parents; // corridor the node was reached throw
+    RouteHeapItem *heap; // at most one item per corridor
+    int heapSize;
+} RouteSearch;
 
 typedef struct {
-    MazePoint *mazePoints;
-    int mazePointsCount;
-} MazePointsArray;
+    signed char dRow;
+    signed char dCol;
+    unsigned char entrySide; // side the next cell is entered throw
+} WallFollowStep;
 
 typedef struct {
-    Point* points;
-    int pointsCount;
-} Path;
+    Map *map;
+    EntryPointsArray *entryPointsArray;
+    int *sameEntryAs; // index of the previous entry point with the same cell, -1 if none
+    int leftRight;
+    int threadIdx;
+    int threadsCount;
+    char **outputs; // printed path of every entry point
+    size_t *outputSizes;
+    enum MazeStatus status; // MAZE_ERROR_MEMORY if a path could not be printed
+} FollowerThread;
+
+typedef struct { // atomic, the graph is built by more threads
+    _Atomic unsigned long allocations;
+    _Atomic unsigned long reallocations;
+    bool enabled; // set by --bench and --stats before any thread starts, the allocator does not count otherwise
+} AllocationCounters;
+
+static AllocationCounters allocationCounters = {0, 0, false};
 
 typedef struct {
-    int* pathIdxes;
-    int pathIdxesCount;
-}ResultPathArray;
+    _Atomic unsigned long cellsParsed;
+    _Atomic unsigned long decisionPoints;
+    _Atomic unsigned long corridorsTraced;
+    _Atomic unsigned long astarPops;
+    _Atomic unsigned long astarPushes;
+    _Atomic unsigned long heuristicEvaluations;
+    _Atomic unsigned long conectionScans;
+} StatsCounters;
+
+// the counters are compiled in only with -DMAZE_STATS, otherwise STAT_INC is a no-op
+#ifdef MAZE_STATS
+static StatsCounters statsCounters = {0, 0, 0, 0, 0, 0, 0};
+#define STAT_INC(counter) (statsCounters.counter++)
+#define STAT_ADD(counter, value) (statsCounters.counter += (value))
+#else
+#define STAT_INC(counter) ((void)0)
+#define STAT_ADD(counter, value) ((void)0)
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 // GENERAL FUNCTIONS
@@ -92,15 +156,38 @@ typedef struct {
 * @brief - coverst strings form 0 to 9 to int
 * @return - returns an int
 */
-int convertCharToInt(char c) {
+static int convertCharToInt(char c) {
     return -1*(c < '0' || c > '9') + (c - '0');
 }
 
+/**
+* @brief - returns the error message of the status
+* @param - enum MazeStatus status
+* @return - const char* message
+*/
+const char *mazeStatusMessage(enum MazeStatus status) {
+    switch (status) {
+        case MAZE_OK:
+            return "OK";
+        case MAZE_ERROR_FILE:
+            return "Error: cannot open file!";
+        case MAZE_ERROR_FORMAT:
+            return "Error: cannot read the maze size!";
+        case MAZE_ERROR_MEMORY:
+            return "Memory allocation error.";
+        case MAZE_ERROR_NOT_ENTRY:
+            return "error, the point you have selected is not an entry point!";
+        case MAZE_ERROR_ENDLESS:
+            return "Error: the path does not end, the maze is invalid!";
+    }
+    return "Unknown error.";
+}
+
 /** 
 * @brief - check weather the triangle cell is pointing up
 * @return - bool
 */
-bool cellPointingUp(int row, int col) {
+static bool cellPointingUp(int row, int col) {
     if (row%2 != col%2)
         return true;
     return false;
@@ -111,7 +198,7 @@ bool cellPointingUp(int row, int col) {
 * @param - int number
 * @return - double square root
 */
-double calcSquareRoot(int number) {
+static double calcSquareRoot(int number) {
     double root = number / 3;
     double lastRoot = 0;
     while (root != lastRoot) {
@@ -129,7 +216,8 @@ double calcSquareRoot(int number) {
  * @param - int col2
  * @return - double distance
  */
-double calculateEuklidianDistance(int row1, int col1, int row2, int col2) {
+static double calculateEuklidianDistance(int row1, int col1, int row2, int col2) {
+    STAT_INC(heuristicEvaluations);
     double d1 = row1 - row2;
     double d2 = col1 - col2;
     return calcSquareRoot(d1*d1 + d2*d2);
@@ -140,21 +228,41 @@ double calculateEuklidianDistance(int row1, int col1, int row2, int col2) {
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
- * @brief - adds an entry point to the array
- * @param - EntryPointsArray struct
- * @param - EntryPoint element
- * @return - void
- * @note - reallocates the memory if needed
+ * @brief - malloc, that is counted in the allocation counters
+ * @param - size_t size
+ * @return - void* pointer to the memory
+ * @note - counts only if the allocation counters are enabled
  */
-void addEntryPointToArray(EntryPointsArray* array, EntryPoint element) {
-    if (array->entryPointsCount % 10 == 0) {
-        array->entryPoints = realloc(array->entryPoints, (array->entryPointsCount + 10) * sizeof(EntryPoint));
-        if (array->entryPoints == NULL) {
-            fprintf(stderr, "Memory reallocation error.\n");
-            exit(1);
-        }
-    }
-    array->entryPoints[array->entryPointsCount++] = element;
+static void *mazeMalloc(size_t size) {
+    if (allocationCounters.enabled)
+        atomic_fetch_add_explicit(&allocationCounters.allocations, 1, memory_order_relaxed);
+    return malloc(size);
+}
+
+/**
+ * @brief - calloc, that is counted in the allocation counters
+ * @param - size_t count
+ * @param - size_t size
+ * @return - void* pointer to the zeroed memory
+ * @note - big blocks are mapped zero pages, only the touched ones take memory
+ */
+static void *mazeCalloc(size_t count, size_t size) {
+    if (allocationCounters.enabled)
+        atomic_fetch_add_explicit(&allocationCounters.allocations, 1, memory_order_relaxed);
+    return calloc(count, size);
+}
+
+/**
+ * @brief - realloc, that is counted in the allocation counters
+ * @param - void* pointer
+ * @param - size_t size
+ * @return - void* pointer to the memory
+ * @note - counts only if the allocation counters are enabled
+ */
+static void *mazeRealloc(void *pointer, size_t size) {
+    if (allocationCounters.enabled)
+        atomic_fetch_add_explicit(&allocationCounters.reallocations, 1, memory_order_relaxed);
+    return realloc(pointer, size);
 }
 
 /**
@@ -162,7 +270,7 @@ void addEntryPointToArray(EntryPointsArray* array, EntryPoint element) {
  * @param - EntryPointsArray struct
  * @return - void
  */
-void freeEntryPointsArray(EntryPointsArray* arrayStruct) {
+static void freeEntryPointsArray(EntryPointsArray* arrayStruct) {
     free(arrayStruct->entryPoints);
 }
 
@@ -170,40 +278,19 @@ void freeEntryPointsArray(EntryPointsArray* arrayStruct) {
  * @brief - adds a maze point to the array
  * @param - MazePointsArray struct
  * @param - MazePoint element
- * @return - void
+ * @return - bool, false if the memory cannot be reallocated (the array is left unchanged)
  */
-void addMazePointToArray(MazePointsArray* array, MazePoint element) {
+static bool addMazePointToArray(MazePointsArray* array, MazePoint element) {
     if (array->mazePointsCount % 10 == 0) {
-        array->mazePoints = realloc(array->mazePoints, (array->mazePointsCount + 10) * sizeof(MazePoint));        
-        if (array->mazePoints == NULL) {
-            fprintf(stderr, "Memory reallocation error.\n");
-            exit(1);
-        }
+        MazePoint *newArray = mazeRealloc(array->mazePoints, (array->mazePointsCount + 10) * sizeof(MazePoint));
+        if (newArray == NULL)
+            return false;
+        array->mazePoints = newArray;
     }
     array->mazePoints[array->mazePointsCount++] = element;
+    return true;
 }
 
-/**
- * @brief - removes a maze point from the array
- * @param - MazePointsArray struct
- * @param - int index
- * @return - void
- * @note - reallocates the memory if needed
- */
-void removeMazePoint(MazePointsArray *array, int index) {
-
-    if (index < 0 || index >= array->mazePointsCount) {
-        fprintf(stderr, "Index out of bounds.\n");
-        return;
-    }
-    MazePoint* elementToRemove = array->mazePoints + index;
-    MazePoint* nextElement = elementToRemove + 1;
-    size_t bytesToMove = (array->mazePointsCount - index - 1) * sizeof(MazePoint);
-    memmove(elementToRemove, nextElement, bytesToMove);
-    array->mazePointsCount--;
-}
-
-
 /**
  * @brief - frees the maze points array
  * @param - MazePointsArray struct
@@ -221,40 +308,19 @@ void freeMazePointsArray(MazePointsArray *array) {
  * @param - int** array
  * @param - int* size
  * @param - int element
- * @return - void
+ * @return - bool, false if the memory cannot be reallocated (the array is left unchanged)
  * @note - reallocates the memory if needed
  */
-void addToIntArray(int** array, int* size, int element) {
-    if (*size % 20 == 0) {
-        int *newArray = realloc(*array, (*size + 10) * sizeof(int));
-        if (newArray == NULL) {
-            fprintf(stderr, "Memory reallocation error int.\n");
-            exit(1);
-        }
+static bool addToIntArray(int** array, int* size, int element) {
+    if (*size % 10 == 0) {
+        int *newArray = mazeRealloc(*array, (*size + 10) * sizeof(int));
+        if (newArray == NULL)
+            return false;
         *array = newArray;
     }
     (*array)[*size] = element;
     (*size) += 1;
-}
-
-/**
- * @brief - removes an int at index form the array
- * @param - int* array
- * @param - int* size
- * @param - int index
- * @return - void
- */
-void removeIntAtIndexFromArray(int* array, int* size, int index) {
-    if (index < 0 || index >= *size) {
-        // Index out of bounds, handle the error as needed
-        fprintf(stderr, "Index out of bounds.\n");
-        return;
-    }
-    int* elementToRemove = array + index;
-    int* nextElement = elementToRemove + 1;
-    size_t bytesToMove = (*size - index - 1) * sizeof(int);
-    memmove(elementToRemove, nextElement, bytesToMove);
-    (*size)--;
+    return true;
 }
 
 /**
@@ -262,20 +328,65 @@ void removeIntAtIndexFromArray(int* array, int* size, int index) {
  * @param - enum Sides** array
  * @param - int* size
  * @param - enum Sides element
- * @return - void
+ * @return - bool, false if the memory cannot be reallocated (the array is left unchanged)
  */
-void addToEnumSidesarray(enum Sides** array, int* size, enum Sides element) {
+static bool addToEnumSidesarray(enum Sides** array, int* size, enum Sides element) {
     if (*size % 10 == 0) {
-        enum Sides* new_array = realloc(*array, (*size + 10) * sizeof(enum Sides));
-
-        if (new_array == NULL) {
-            fprintf(stderr, "Memory reallocation error.\n");
-            exit(1);
-        }
+        enum Sides* new_array = mazeRealloc(*array, (*size + 10) * sizeof(enum Sides));
+        if (new_array == NULL)
+            return false;
         *array = new_array; // Update the pointer to the new array
     }
     (*array)[*size] = element;
     (*size) += 1;
+    return true;
+}
+
+/**
+ * @brief - returns the number of bytes needed for the cells of the map
+ * @param - Map struct, rows, cols and layout set
+ * @return - size_t
+ * @note - the tiled layout is padded to whole tiles
+ */
+static size_t cellsSize(Map *map) {
+    if (map->layout == LAYOUT_ROW_MAJOR)
+        return (size_t)map->rows * map->cols;
+    size_t tileRows = (map->rows + TILE_SIZE - 1) >> TILE_SHIFT;
+    size_t tileCols = (map->cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    return (tileRows * tileCols) << (2 * TILE_SHIFT);
+}
+
+/**
+ * @brief - chooses the layout of the cells and allocates them
+ * @param - Map struct, rows and cols set
+ * @param - enum CellLayout layout, LAYOUT_AUTO to choose by the size of the map
+ * @return - bool, false if the memory cannot be allocated
+ * @note - maps so wide that a tile high band of rows does not fit in the L2 cache are tiled,
+ *         so the vertical moves stay in the same part of the memory
+ */
+static bool allocateCells(Map *map, enum CellLayout layout) {
+    map->layout = layout;
+    if (map->layout == LAYOUT_AUTO)
+        map->layout = map->rows >= TILE_SIZE && map->cols >= TILE_SIZE && (long)map->cols * TILE_SIZE > L2_CACHE_SIZE
+                          ? LAYOUT_TILED : LAYOUT_ROW_MAJOR;
+    map->cells = mazeMalloc(cellsSize(map) * sizeof(unsigned char));
+    return map->cells != NULL;
+}
+
+/**
+ * @brief - frees the cached entry points of the map
+ * @param - Map struct
+ * @return - void
+ * @note - findEntryPoints builds them again, needed after a wall on the border is changed
+ */
+static void freePerimeter(Map *map) {
+    if (map->perimeter == NULL)
+        return;
+    freeEntryPointsArray(&map->perimeter->entries);
+    free(map->perimeter->sides);
+    free((void *)map->perimeter->jumps);
+    free(map->perimeter);
+    map->perimeter = NULL;
 }
 
 /**
@@ -285,12 +396,30 @@ void addToEnumSidesarray(enum Sides** array, int* size, enum Sides element) {
  */
 void freeMap(Map mapOfMaze) {
     free(mapOfMaze.cells);
+    free(mapOfMaze.costs);
+    freePerimeter(&mapOfMaze);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 // MAZE FUNCTIONS
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief - returns the index of the cell in the cells array
+ * @param - Map struct
+ * @param - int row
+ * @param - int col
+ * @return - size_t index
+ * @note - the cell has to be inside the map
+ */
+static inline size_t cellIndex(Map *map, int row, int col) {
+    if (map->layout == LAYOUT_ROW_MAJOR)
+        return (size_t)(row-1)*map->cols + (col-1);
+    size_t tileCols = (map->cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    size_t tile = ((size_t)(row-1) >> TILE_SHIFT) * tileCols + ((col-1) >> TILE_SHIFT);
+    return (tile << (2 * TILE_SHIFT)) + (((row-1) & (TILE_SIZE - 1)) << TILE_SHIFT) + ((col-1) & (TILE_SIZE - 1));
+}
+
 /**
  * @brief - returns the cell value from the map
  * @param - Map struct
@@ -299,11 +428,22 @@ void freeMap(Map mapOfMaze) {
  * @return - unsigned char, cell value
  * @note - if the cell is outside the map, returns '?'
  */
-unsigned char getCell(Map *map, int row, int col) {
+static unsigned char getCell(Map *map, int row, int col) {
     if (row < 1 || row > map->rows || col < 1 || col > map->cols) // check if the cell is inside the map
         return '?';
-    int numOfCols = map->cols;
-    return map->cells[(row-1)*numOfCols + (col-1)];
+    return map->cells[cellIndex(map, row, col)];
+}
+
+/**
+ * @brief - returns the cost of entering the cell
+ * @param - Map struct
+ * @param - int row
+ * @param - int col
+ * @return - int, cost, 1 if the maze has no costs
+ * @note - the cell has to be inside the map
+ */
+static inline int cellCost(Map *map, int row, int col) {
+    return map->costs == NULL ? 1 : map->costs[cellIndex(map, row, col)];
 }
 
 /**
@@ -314,7 +454,7 @@ unsigned char getCell(Map *map, int row, int col) {
  * @param - int side
  * @return - bool, 0, 1, border is there or not
  */
-bool isBorder(Map *map, int row, int col, int side) {
+static bool isBorder(Map *map, int row, int col, int side) {
     int cell = convertCharToInt(getCell(map, row, col));
     return (cell >> side) & 0x01;
 }
@@ -324,43 +464,35 @@ bool isBorder(Map *map, int row, int col, int side) {
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
- * @brief - loads the maze from the file
- * @param - char* filename
- * @return - Map struct
- * @note - exits the program if the file cannot be opened
+ * @brief - loads the maze from the opened stream
+ * @param - FILE* file, the stream is not closed
+ * @param - Map* maze, the loaded maze (cells are NULL on error)
+ * @param - enum CellLayout layout, of the cells, LAYOUT_AUTO to choose by the size of the map
+ * @return - enum MazeStatus, MAZE_ERROR_FORMAT or MAZE_ERROR_MEMORY on error
+ * @note - the faces of all the cells (3 per cell) have to fit into an int, they are indexed by ints
  */
-Map loadMaze(char* filename){
-
-    Map maze;
-    FILE* file = fopen(filename, "r");
+enum MazeStatus loadMazeStream(FILE *file, Map *maze, enum CellLayout layout) {
 
-    if (file == NULL) {
-        fprintf(stderr, "Error: cannot open file!\n");
-        exit(1);
-    }
+    maze->cells = NULL;
+    maze->costs = NULL;
+    maze->minCost = 1;
+    maze->perimeter = NULL;
 
     // load the maze size
-    maze.rows = -1;
-    maze.cols = -1;
-
-    if (fscanf(file, "%d %d", &maze.rows, &maze.cols)!= 2) {
-        printf("Invalid\n");
-        fprintf(stderr, "Error parsing values from the first line.\n");
-        fclose(file);
-        exit(1);
-    }
+    maze->rows = -1;
+    maze->cols = -1;
 
-    if (maze.rows == -1 || maze.cols == -1) {
-        printf("Invalid\n");
-        fprintf(stderr, "Error: cannot read the maze size!\n");
-        fclose(file);
-        exit(1);
+    if (fscanf(file, "%d %d", &maze->rows, &maze->cols)!= 2 || maze->rows < 0 || maze->cols < 0 ||
+        (long long)maze->rows * maze->cols > INT_MAX / 3) {
+        return MAZE_ERROR_FORMAT;
     }
 
     // alocate the memmory for the cells, as well as the file line
-    maze.cells = malloc((maze.rows * maze.cols) * sizeof(unsigned char)); 
+    if (!allocateCells(maze, layout)) {
+        return MAZE_ERROR_MEMORY;
+    }
 
-    char ch;
+    int ch;
     int counter = 0;
     int rowCounter = 0;
 
@@ -368,48 +500,95 @@ Map loadMaze(char* filename){
 
         ch = fgetc(file);
 
-        if (ch == EOF || counter == maze.rows * maze.cols) 
+        if (ch == EOF || counter == maze->rows * maze->cols) 
             break;
 
-        if (rowCounter == maze.cols) { // this may need some changing .. user row Counter I guess
+        if (rowCounter == maze->cols) { // this may need some changing .. user row Counter I guess
             rowCounter = 0;
             continue;
         }
 
-        if ((ch >= '0' && ch <= '7') && rowCounter < maze.cols) {
-            maze.cells[counter++] = ch;
+        if ((ch >= '0' && ch <= '7') && rowCounter < maze->cols) {
+            maze->cells[cellIndex(maze, counter / maze->cols + 1, rowCounter + 1)] = ch;
+            counter++;
+            STAT_INC(cellsParsed);
             rowCounter++;
             continue;
         }
     }
 
-    if (counter != maze.rows * maze.cols) {
-        printf("Invalid\n");
-        fprintf(stderr, "Error: cannot read the maze size!\n");
-        fclose(file);
-        exit(1);
+    if (counter != maze->rows * maze->cols) {
+        free(maze->cells);
+        maze->cells = NULL;
+        return MAZE_ERROR_FORMAT;
     }
-    
+    return MAZE_OK;
+}
+
+/**
+ * @brief - loads the maze from the file
+ * @param - char* filename
+ * @param - Map* maze, the loaded maze (cells are NULL on error)
+ * @param - enum CellLayout layout, of the cells, LAYOUT_AUTO to choose by the size of the map
+ * @return - enum MazeStatus, MAZE_ERROR_FILE, MAZE_ERROR_FORMAT or MAZE_ERROR_MEMORY on error
+ */
+enum MazeStatus loadMaze(char* filename, Map *maze, enum CellLayout layout){
+
+    maze->cells = NULL;
+    maze->costs = NULL;
+    maze->perimeter = NULL;
+    FILE* file = fopen(filename, "r");
+
+    if (file == NULL)
+        return MAZE_ERROR_FILE;
+
+    enum MazeStatus status = loadMazeStream(file, maze, layout);
     fclose(file);
-    return maze;
+    return status;
 }
 
 /**
- * @brief - represents the maze
- * @param - Map struct
- * @return - void
- * @note - prints the maze to the stdout
+ * @brief - loads the costs of entering the cells from the file
+ * @param - char* filename, the same format as the maze, the numbers are from 0 to 255
+ * @param - Map* maze, loaded maze
+ * @return - enum MazeStatus, MAZE_ERROR_FILE, MAZE_ERROR_FORMAT or MAZE_ERROR_MEMORY on error
+ * @note - the size has to be the same as the size of the maze
  */
-void representMaze(Map mapOfMaze) {
-    for (int i = 0; i < mapOfMaze.rows; i++) {
-        for (int j = 0; j < mapOfMaze.cols; j++) {
-            printf("%c ", mapOfMaze.cells[i*mapOfMaze.cols + j]);
+enum MazeStatus loadCosts(char* filename, Map *maze) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL)
+        return MAZE_ERROR_FILE;
+
+    int rows, cols;
+    if (fscanf(file, "%d %d", &rows, &cols) != 2 || rows != maze->rows || cols != maze->cols) {
+        fclose(file);
+        return MAZE_ERROR_FORMAT;
+    }
+    unsigned char *costs = mazeMalloc(cellsSize(maze) * sizeof(unsigned char));
+    if (costs == NULL) {
+        fclose(file);
+        return MAZE_ERROR_MEMORY;
+    }
+    int minCost = 255;
+    int cost;
+    for (int row = 1; row <= rows; row++) {
+        for (int col = 1; col <= cols; col++) {
+            if (fscanf(file, "%d", &cost) != 1 || cost < 0 || cost > 255) {
+                free(costs);
+                fclose(file);
+                return MAZE_ERROR_FORMAT;
+            }
+            costs[cellIndex(maze, row, col)] = cost;
+            minCost = cost < minCost ? cost : minCost;
         }
-        printf("\n");
     }
+    fclose(file);
+    free(maze->costs);
+    maze->costs = costs;
+    maze->minCost = minCost;
+    return MAZE_OK;
 }
 
-
 /**
  * @brief - checks the maze validity
  * @param - Map struct
@@ -439,65 +618,173 @@ bool checkMazeValidity(Map mapOfMaze) {
 
 
 /**
- * @brief - finds the entry points of the maze
- * @param - Map struct
- * @return - EntryPointsArray struct
+ * @brief - finds the openings in the straight faces of the first or the last row
+ * @param - Map struct, at least one cell
+ * @param - int row
+ * @param - bool pointingUp, the cells with the straight face on the border (false in the first row, true in the last one)
+ * @param - unsigned char* sides, entry sides of the row (indexed by col-1), the openings are set to STRAIGHT
+ * @return - int, number of the openings
+ * @note - the row is read 8 cells at a time, the straight walls of every second cell are masked in one word
+ *         and the openings are taken from it bit by bit, a tiled row is contiguous up to the end of the tile
  */
-EntryPointsArray findEntryPoints(Map *map) {
+static int findStraightOpenings(Map *map, int row, bool pointingUp, unsigned char *sides) {
+    int count = 0;
+    for (int col = 1; col <= map->cols; ) {
+        int length = map->cols - col + 1;
+        if (map->layout != LAYOUT_ROW_MAJOR && length > TILE_SIZE - ((col-1) & (TILE_SIZE-1)))
+            length = TILE_SIZE - ((col-1) & (TILE_SIZE-1));
+        const unsigned char *cells = &map->cells[cellIndex(map, row, col)];
+        int i = 0;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // byte i of the word is the cell col+i, the cells are '0'-'7', so the wall bits are the bits of the char
+        uint64_t faces = (cellPointingUp(row, col) == pointingUp ? 0x0001000100010001ULL : 0x0100010001000100ULL) << STRAIGHT;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            memcpy(&word, cells + i, sizeof(word));
+            for (uint64_t open = ~word & faces; open != 0; open &= open - 1) {
+                sides[col + i + (__builtin_ctzll(open) >> 3) - 1] = STRAIGHT;
+                count++;
+            }
+        }
+#endif
+        for (; i < length; i++) {
+            if (cellPointingUp(row, col + i) == pointingUp && !(((cells[i] - '0') >> STRAIGHT) & 0x01)) {
+                sides[col + i - 1] = STRAIGHT;
+                count++;
+            }
+        }
+        col += length;
+    }
+    return count;
+}
 
-    EntryPointsArray entryArray = {NULL, 0};
-    int row = 1; 
-    int col = 1;
-    
-    for (col = 1; col <= map->cols; col++) { // top side
-        if (!isBorder(map, row, col, STRAIGHT) && !cellPointingUp(row, col))  
-            addEntryPointToArray(&entryArray, (EntryPoint){row, col, STRAIGHT});
+/**
+ * @brief - finds the entry points of the maze and caches them on the map
+ * @param - Map struct
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - a map without cells has no entry points (the sides would be checked outside of it)
+ */
+static enum MazeStatus buildPerimeter(Map *map) {
+    int rows = map->rows;
+    int cols = map->cols;
+    int positions = 2 * (rows + cols); // top row, right column, bottom row, left column
+    Perimeter *perimeter = mazeMalloc(sizeof(Perimeter));
+    unsigned char *sides = mazeMalloc((positions + 1) * sizeof(unsigned char));
+    if (perimeter == NULL || sides == NULL) {
+        free(perimeter);
+        free(sides);
+        return MAZE_ERROR_MEMORY;
+    }
+    memset(sides, NO_ENTRY_SIDE, positions + 1);
+
+    int count = 0;
+    if (rows != 0 && cols != 0) {
+        count += findStraightOpenings(map, 1, false, sides);
+        count += findStraightOpenings(map, rows, true, sides + cols + rows);
+        for (int row = 1; row <= rows; row++) {
+            if (!isBorder(map, row, cols, DIAGONAL_RIGHT)) {
+                sides[cols + row - 1] = DIAGONAL_RIGHT;
+                count++;
+            }
+            if (!isBorder(map, row, 1, DIAGONAL_LEFT)) {
+                sides[2*cols + rows + row - 1] = DIAGONAL_LEFT;
+                count++;
+            }
+        }
     }
-    col = map->cols; // right side
-    for (row = 1; row <= map->rows; row++) {
-        if (!isBorder(map, row, col, DIAGONAL_RIGHT))
-            addEntryPointToArray(&entryArray, (EntryPoint){row, col, DIAGONAL_RIGHT});
+    EntryPoint *entries = mazeMalloc((count + 1) * sizeof(EntryPoint));
+    if (entries == NULL) {
+        free(perimeter);
+        free(sides);
+        return MAZE_ERROR_MEMORY;
     }
-    row = map->rows; // bottom side
-    for (col = 1; col <= map->cols; col++) {
-        if (!isBorder(map, row, col, STRAIGHT) && cellPointingUp(row, col))
-            addEntryPointToArray(&entryArray, (EntryPoint){row, col, STRAIGHT});
+    int found = 0;
+    for (int i = 0; i < positions && found < count; i++) {
+        if (sides[i] == NO_ENTRY_SIDE)
+            continue;
+        if (i < cols)
+            entries[found++] = (EntryPoint){1, i + 1, sides[i]};
+        else if (i < cols + rows)
+            entries[found++] = (EntryPoint){i - cols + 1, cols, sides[i]};
+        else if (i < 2*cols + rows)
+            entries[found++] = (EntryPoint){rows, i - cols - rows + 1, sides[i]};
+        else
+            entries[found++] = (EntryPoint){i - 2*cols - rows + 1, 1, sides[i]};
     }
-    col = 1; // left side
-    for (row = 1; row <= map->rows; row++) { // left side
-        if (!isBorder(map, row, col, DIAGONAL_LEFT))
-            addEntryPointToArray(&entryArray, (EntryPoint){row, col, DIAGONAL_LEFT});
+    // the walks run without output can skip the corridors they followed before, also from more threads
+    _Atomic uint64_t *jumps = mazeCalloc(cellsSize(map) * 3 + 1, sizeof(uint64_t));
+    *perimeter = (Perimeter){{entries, count}, sides, jumps};
+    map->perimeter = perimeter;
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the entry points of the maze
+ * @param - Map struct
+ * @param - EntryPointsArray* entryArray, the found entry points (empty on error), they belong to the map and are freed by freeMap
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - the points are found once and cached on the map (the first call is not thread safe),
+ *         ordered by the top row, the right column, the bottom row and the left column
+ */
+enum MazeStatus findEntryPoints(Map *map, EntryPointsArray *entryArray) {
+    *entryArray = (EntryPointsArray){NULL, 0};
+    if (map->perimeter == NULL) {
+        enum MazeStatus status = buildPerimeter(map);
+        if (status != MAZE_OK)
+            return status;
     }
-    return entryArray;
+    *entryArray = map->perimeter->entries;
+    return MAZE_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 // MAZE SOLVING FUNCTIONS
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief - returns the first open border position of the cell, in the order of findEntryPoints
+ * @param - Map struct, the entry points are already found
+ * @param - int row
+ * @param - int col
+ * @return - int, index into the sides of the perimeter, -1 if the cell is not an entry point
+ * @note - a corner cell has two border positions, the first open one is used
+ */
+static int entryPosition(Map *map, int row, int col) {
+    if (row < 1 || row > map->rows || col < 1 || col > map->cols)
+        return -1;
+    int positions[4] = {
+        row == 1 ? col - 1 : -1,
+        col == map->cols ? map->cols + row - 1 : -1,
+        row == map->rows ? map->cols + map->rows + col - 1 : -1,
+        col == 1 ? 2*map->cols + map->rows + row - 1 : -1
+    };
+    for (int i = 0; i < 4; i++) {
+        if (positions[i] != -1 && map->perimeter->sides[positions[i]] != NO_ENTRY_SIDE)
+            return positions[i];
+    }
+    return -1;
+}
+
 /**
  * @brief - returns the entry side of the maze
  * @param - Map struct
  * @param - int row
  * @param - int col
- * @return - enum Sides, entry side
- * @note - exits the program if the point is not an entry point
+ * @param - enum Sides* entrySide, the side the maze is entered throw
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY if the point is not an entry point
+ * @note - the side is looked up by the border position of the cell in the entry points cached by findEntryPoints
  */
-enum Sides startBorder(Map *map, int row, int col) {
-
-    EntryPointsArray entryPointsArr = findEntryPoints(map);
-    enum Sides entrySide;
-    for (int i = 0; i < entryPointsArr.entryPointsCount; i++) { // here if i add -1 to the 2nd condition, ivalid read is gone ... ?
-        if (entryPointsArr.entryPoints[i].row == row && entryPointsArr.entryPoints[i].col == col) {
-            entrySide = entryPointsArr.entryPoints[i].entrySide;
-            freeEntryPointsArray(&entryPointsArr);
-            return entrySide;
-        }
-    }
-    fprintf(stderr, "error, the point you have selected is not an entry point!\n");
-    freeEntryPointsArray(&entryPointsArr);
-    freeMap(*map);
-    exit(1);
+enum MazeStatus startBorder(Map *map, int row, int col, enum Sides *entrySide) {
+
+    EntryPointsArray entryPointsArr;
+    enum MazeStatus status = findEntryPoints(map, &entryPointsArr);
+    if (status != MAZE_OK)
+        return status;
+    int position = entryPosition(map, row, col);
+    if (position == -1)
+        return MAZE_ERROR_NOT_ENTRY;
+    *entrySide = map->perimeter->sides[position];
+    return MAZE_OK;
 }
 
 /**
@@ -510,7 +797,7 @@ enum Sides startBorder(Map *map, int row, int col) {
  * @return - void
  * @note - changes the entry side to the next face
  */
-void chooseFaceToMoveThrow(Map *map, int currentRow, int currentCol, enum Sides *entrySide, int leftRight) {
+static void chooseFaceToMoveThrow(Map *map, int currentRow, int currentCol, enum Sides *entrySide, int leftRight) {
     bool cellPointsUp = cellPointingUp(currentRow, currentCol);
     int direction;
     if ((cellPointsUp && leftRight == 0) || (!cellPointsUp && leftRight == 1))
@@ -533,7 +820,7 @@ void chooseFaceToMoveThrow(Map *map, int currentRow, int currentCol, enum Sides
  * @param - enum Sides* entrySide
  * @return - void
  */
-void moveDirection(int *currentRow, int *currentCol, enum Sides *entrySide) {
+static void moveDirection(int *currentRow, int *currentCol, enum Sides *entrySide) {
     // left right
     if (*entrySide == DIAGONAL_LEFT) {
         *currentCol -= 1;
@@ -554,74 +841,204 @@ void moveDirection(int *currentRow, int *currentCol, enum Sides *entrySide) {
         *currentRow -= 1;
 }
 
+// one step of the wall follower {dRow, dCol, side the next cell is entered throw}, indexed by [right/left][cell value][cell pointing up][entry side],
+// the first open face in the rotation of chooseFaceToMoveThrow, left and moved throw as moveDirection does
+static const WallFollowStep wallFollowTables[2][8][2][3] = {
+    { // right hand
+        {{{0, 1, DIAGONAL_LEFT}, {-1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}}}, // '0'
+        {{{0, 1, DIAGONAL_LEFT}, {-1, 0, STRAIGHT}, {0, 1, DIAGONAL_LEFT}}, {{1, 0, STRAIGHT}, {1, 0, STRAIGHT}, {0, 1, DIAGONAL_LEFT}}}, // '1'
+        {{{-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '2'
+        {{{-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}}, {{1, 0, STRAIGHT}, {1, 0, STRAIGHT}, {1, 0, STRAIGHT}}}, // '3'
+        {{{0, 1, DIAGONAL_LEFT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{0, 1, DIAGONAL_LEFT}, {0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}}}, // '4'
+        {{{0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}}, {{0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}}}, // '5'
+        {{{0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '6'
+        {{{0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}, {-1, 0, STRAIGHT}}, {{0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}, {1, 0, STRAIGHT}}} // '7'
+    },
+    { // left hand
+        {{{-1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}}, {{0, 1, DIAGONAL_LEFT}, {1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '0'
+        {{{-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}, {0, 1, DIAGONAL_LEFT}}, {{0, 1, DIAGONAL_LEFT}, {1, 0, STRAIGHT}, {0, 1, DIAGONAL_LEFT}}}, // '1'
+        {{{-1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{1, 0, STRAIGHT}, {1, 0, STRAIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '2'
+        {{{-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}, {-1, 0, STRAIGHT}}, {{1, 0, STRAIGHT}, {1, 0, STRAIGHT}, {1, 0, STRAIGHT}}}, // '3'
+        {{{0, 1, DIAGONAL_LEFT}, {0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}}, {{0, 1, DIAGONAL_LEFT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '4'
+        {{{0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}}, {{0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}, {0, 1, DIAGONAL_LEFT}}}, // '5'
+        {{{0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}, {{0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}, {0, -1, DIAGONAL_RIGHT}}}, // '6'
+        {{{0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}, {-1, 0, STRAIGHT}}, {{0, -1, DIAGONAL_RIGHT}, {0, 1, DIAGONAL_LEFT}, {1, 0, STRAIGHT}}} // '7'
+    }
+};
+
+// the only face a cell can be left throw, when entered throw the side, indexed by [cell value][entry side],
+// -1 if the entry side is a wall or there is a choice (a decision point), a dead end is left throw the entry side
+static const signed char corridorExitSides[8][3] = {
+    {-1, -1, -1}, {-1, STRAIGHT, DIAGONAL_RIGHT}, {STRAIGHT, -1, DIAGONAL_LEFT}, {-1, -1, STRAIGHT},
+    {DIAGONAL_RIGHT, DIAGONAL_LEFT, -1}, {-1, DIAGONAL_RIGHT, -1}, {DIAGONAL_LEFT, -1, -1}, {-1, -1, -1}
+};
+
 /**
- * @brief - solves the maze
+ * @brief - returns the face the corridor cell is left throw
  * @param - Map struct
- * @param - int leftRight, 0, 1, left or right
- * @param - int row, int col (entry point)
- * @return - void
- * @note - prints the path to the stdout
+ * @param - int row
+ * @param - int col
+ * @param - enum Sides entrySide
+ * @return - int, enum Sides of the exit, -1 if the cell is not a corridor cell
+ * @note - the cells of the border are never corridor cells, so the corridors neither leave the map nor contain the entry point
+ */
+static inline int corridorExitSide(Map *map, int row, int col, enum Sides entrySide) {
+    if (row == 1 || row == map->rows || col == 1 || col == map->cols)
+        return -1;
+    return corridorExitSides[map->cells[cellIndex(map, row, col)] - '0'][entrySide];
+}
+
+/**
+ * @brief - follows the corridor from its first cell to the first cell, that is not a corridor cell
+ * @param - Map struct
+ * @param - int row, int col (the first cell of the corridor, already walked)
+ * @param - enum Sides entrySide
+ * @param - FILE* output, stream the cells inside the corridor are printed to (not the first one and not the end), NULL to not print them
+ * @param - long* stepsLeft, steps the walk can still make, decreased by every step
+ * @return - uint64_t, the end of the corridor (row << 32 | col << 2 | entry side), 0 if the walk ran out of the steps
+ * @note - both hands go the same way throw a corridor, so the end is the same for the left and the right hand rule
  */
-void solve_maze(Map *mapOfMaze, int leftright, int row, int col) {
+static uint64_t followCorridor(Map *map, int row, int col, enum Sides entrySide, FILE *output, long *stepsLeft) {
+    int exitSide = corridorExitSide(map, row, col, entrySide);
+    while (exitSide != -1) {
+        if ((*stepsLeft)-- <= 0)
+            return 0;
+        enum Sides side = exitSide;
+        moveDirection(&row, &col, &side);
+        entrySide = side;
+        exitSide = corridorExitSide(map, row, col, entrySide);
+        if (exitSide != -1 && output != NULL)
+            fprintf(output, "%d,%d\n", row, col);
+    }
+    return (uint64_t)row << 32 | (uint64_t)col << 2 | entrySide;
+}
 
+/**
+ * @brief - walks the maze with the wall follower, one table lookup per step, the corridors in one step
+ * @param - Map struct
+ * @param - const WallFollowStep table[8][2][3], steps of the left or right hand rule
+ * @param - int row, int col (entry point)
+ * @param - enum Sides entryDirection
+ * @param - FILE* output, stream the path is printed to, NULL to only walk the maze
+ * @param - Point* end, the cell the walk ends in (out of the map at the exit, or the entry point), NULL if not needed
+ * @return - enum MazeStatus, MAZE_ERROR_ENDLESS if the walk neither leaves the map nor returns to the entry point
+ * @note - inlined into followLeftHand and followRightHand, each loads the steps from its own constant table,
+ *         every cell can be entered throw 3 faces, so on a valid maze the walk ends within 3 * rows * cols steps,
+ *         without output the ends of the corridors are remembered on the map and the next walks jump over them,
+ *         with output the corridors are followed cell by cell to print them
+ */
+static inline enum MazeStatus wallFollowKernel(Map *map, const WallFollowStep table[8][2][3], int row, int col, enum Sides entryDirection, FILE *output, Point *end) {
     int currentRow = row;
     int currentCol = col;
-    enum Sides entryDirection = startBorder(mapOfMaze, row, col);
-
-    printf("%d,%d\n", currentRow, currentCol); // entry point
-
-    while (1) {
-        chooseFaceToMoveThrow(mapOfMaze, currentRow, currentCol, &entryDirection, leftright);
-        moveDirection(&currentRow, &currentCol, &entryDirection);
+    int pointsUp = cellPointingUp(row, col);
+    WallFollowStep step;
+    long stepsLeft = 3L * map->rows * map->cols + 1;
+    _Atomic uint64_t *jumps = map->perimeter != NULL ? map->perimeter->jumps : NULL;
+
+    while (stepsLeft-- > 0) {
+        if (corridorExitSide(map, currentRow, currentCol, entryDirection) != -1) {
+            _Atomic uint64_t *jump = jumps != NULL && output == NULL ? &jumps[cellIndex(map, currentRow, currentCol) * 3 + entryDirection] : NULL;
+            uint64_t corridorEnd = jump != NULL ? atomic_load_explicit(jump, memory_order_relaxed) : 0;
+            if (corridorEnd == 0) {
+                corridorEnd = followCorridor(map, currentRow, currentCol, entryDirection, output, &stepsLeft);
+                if (corridorEnd == 0)
+                    break;
+                if (jump != NULL)
+                    atomic_store_explicit(jump, corridorEnd, memory_order_relaxed);
+            }
+            currentRow = corridorEnd >> 32;
+            currentCol = (corridorEnd >> 2) & 0x3FFFFFFF;
+            entryDirection = corridorEnd & 0x03;
+            pointsUp = cellPointingUp(currentRow, currentCol);
+        } else {
+            step = table[map->cells[cellIndex(map, currentRow, currentCol)] - '0'][pointsUp][entryDirection];
+            pointsUp ^= 1;
+            currentRow += step.dRow;
+            currentCol += step.dCol;
+            entryDirection = step.entrySide;
+        }
 
         // if we end up outside the map, the maze is solved
-        if (currentRow == 0 || currentRow == mapOfMaze->rows+1 || currentCol == 0 || currentCol == mapOfMaze->cols+1) {
-            break;
+        if (currentRow == 0 || currentRow == map->rows+1 || currentCol == 0 || currentCol == map->cols+1) {
+            if (end != NULL)
+                *end = (Point){currentRow, currentCol};
+            return MAZE_OK;
         }
         // if we end up at the starting point, the maze cannot be solved
         if (currentRow == row && currentCol == col) {
-            return;
+            if (end != NULL)
+                *end = (Point){currentRow, currentCol};
+            return MAZE_OK;
         }
         // stepping close to the exit
-        printf("%d,%d\n", currentRow, currentCol);
+        if (output != NULL)
+            fprintf(output, "%d,%d\n", currentRow, currentCol);
     }
+    // the walk goes round a loop, that does not contain the entry point (the cells do not agree on their walls)
+    return MAZE_ERROR_ENDLESS;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-// MAZE SIMPLIFICATION FUNCTIONS
-///////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief - wall follower with the table of the right hand rule (--rpath)
+ */
+static enum MazeStatus followRightHand(Map *map, int row, int col, enum Sides entryDirection, FILE *output, Point *end) {
+    return wallFollowKernel(map, wallFollowTables[0], row, col, entryDirection, output, end);
+}
 
 /**
- * @brief - chooses the next maze point to be solved
- * @param - MazePointsArray struct
- * @return - int, index of the maze point
- * @note - returns -1 if all maze points are finished
- */
-int chooseMazePoint(MazePointsArray array) {
-    int i = -1;
-    for (int j = 0; j < array.mazePointsCount; j++) { // find unfinished maze point
-        if (!array.mazePoints[j].finished) {
-            i = j;
-            break;
-        }
-    }
-    return i;
+ * @brief - wall follower with the table of the left hand rule (--lpath)
+ */
+static enum MazeStatus followLeftHand(Map *map, int row, int col, enum Sides entryDirection, FILE *output, Point *end) {
+    return wallFollowKernel(map, wallFollowTables[1], row, col, entryDirection, output, end);
+}
+
+/**
+ * @brief - solves the maze
+ * @param - Map struct
+ * @param - int leftRight, 0, 1, left or right
+ * @param - int row, int col (entry point)
+ * @param - FILE* output, stream the path is printed to, NULL to only walk the maze
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY if the point is not an entry point,
+ *           MAZE_ERROR_ENDLESS if the walk does not end (the path printed so far is left in the output)
+ */
+enum MazeStatus solve_maze(Map *mapOfMaze, int leftright, int row, int col, FILE *output) {
+
+    enum Sides entryDirection;
+    enum MazeStatus status = startBorder(mapOfMaze, row, col, &entryDirection);
+    if (status != MAZE_OK)
+        return status;
+
+    if (output != NULL)
+        fprintf(output, "%d,%d\n", row, col); // entry point
+
+    if (leftright == 0)
+        return followRightHand(mapOfMaze, row, col, entryDirection, output, NULL);
+    return followLeftHand(mapOfMaze, row, col, entryDirection, output, NULL);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+// MAZE SIMPLIFICATION FUNCTIONS
+///////////////////////////////////////////////////////////////////////////////////////////////
+
 /**
  * @brief - moves to the next decision point
  * @param - Map struct
  * @param - int* Row
  * @param - int* Col
  * @param - MazePoint* currentMazePoint
- * @return - int, 0, 1, -1, 0 - found a decision point, 1 - found a decision point and we are out of the map, -1 - we are back at the starting point
+ * @param - bool storeMoves, whether to store the faces moved throw (if there is not enough memory, the moves are not stored)
+ * @return - int, 0, 1, -1, 0 - found a decision point, 1 - found a decision point and we are out of the map, -1 - we are back at the starting point (or stuck in a cycle)
  */
-int moveToNextDecisionPoint(Map *map, int *Row, int *Col, MazePoint *currentMazePoint) {
+static int moveToNextDecisionPoint(Map *map, int *Row, int *Col, MazePoint *currentMazePoint, bool storeMoves) {
     // move in a direction, untill we find a decision point
     unsigned char cellValue;
     int distance = 0;
+    long long cost = 0;
     enum Sides *moveThrowFaces = NULL;
     enum Sides currnetDir = currentMazePoint->currentDir;
+    // every cell is entered at most once throw each of its 3 faces, longer walk is a cycle (invalid map)
+    long maxDistance = 3L * map->rows * map->cols;
+    STAT_INC(corridorsTraced);
 
     while (1) {
         cellValue = getCell(map, *Row, *Col);
@@ -637,15 +1054,26 @@ int moveToNextDecisionPoint(Map *map, int *Row, int *Col, MazePoint *currentMaze
             currentMazePoint->endPoint.col = *Col;
             currentMazePoint->finished = true;
             currentMazePoint->distance = distance;
+            currentMazePoint->cost = cost;
             currentMazePoint->moveThrowFaces = moveThrowFaces;
             currentMazePoint->currentDir = currnetDir;
+            currentMazePoint->leavesMap = cellValue != '0';
             if (cellValue == '0')
                 return 1;
             return 0;
         }
-        addToEnumSidesarray(&moveThrowFaces, &distance, currnetDir);
+        if (storeMoves && !addToEnumSidesarray(&moveThrowFaces, &distance, currnetDir)) {
+            // out of memory, the corridor is walked again in reconstructPath instead
+            free(moveThrowFaces);
+            moveThrowFaces = NULL;
+            storeMoves = false;
+        }
+        if (!storeMoves)
+            distance++;
         moveDirection(Row, Col, &currnetDir);
-        if (*Row == currentMazePoint->startPoint.row && *Col == currentMazePoint->startPoint.col) { 
+        if (getCell(map, *Row, *Col) != '?')
+            cost += cellCost(map, *Row, *Col);
+        if ((*Row == currentMazePoint->startPoint.row && *Col == currentMazePoint->startPoint.col) || distance > maxDistance) { 
             free(moveThrowFaces);
             distance = 0;
             return -1;
@@ -659,33 +1087,59 @@ int moveToNextDecisionPoint(Map *map, int *Row, int *Col, MazePoint *currentMaze
  * @param - Map struct
  * @param - int startRow
  * @param - int startCol
- * @return - MazePointsArray struct
- * @note - returns all the "decision points" in the maze (points where the path splits)
+ * @param - bool storeMoves, whether to store the faces moved throw (needed only to print the path)
+ * @param - Point* foundExit, if not NULL, the simplification stops at the first exit, that is stored here ({-1, -1} if none)
+ * @param - MazePointsArray* result, all the "decision points" in the maze (points where the path splits), empty on error
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY or MAZE_ERROR_MEMORY on error
+ * @note - the corridors are traced in the order they are found (the array is the queue), every face of a cell
+ *         starts at most one corridor (a bit per face and cell), the corridors leading back to their start are removed at the end
  */
-MazePointsArray simplifyMaze(Map *map, int startRow, int startCol) { 
+enum MazeStatus simplifyMaze(Map *map, int startRow, int startCol, bool storeMoves, Point *foundExit, MazePointsArray *result) { 
     
     MazePointsArray mazePointsArr = {NULL, 0};
-    enum Sides startDirection = startBorder(map, startRow, startCol);
-    chooseFaceToMoveThrow(map, startRow, startCol, &startDirection, 1);
-    MazePoint cMazeP = {{startRow, startCol}, {startRow, startCol}, startDirection, 0, NULL, false};
-    addMazePointToArray(&mazePointsArr, cMazeP);
+    *result = mazePointsArr;
+    enum Sides startDirection;
+    enum MazeStatus status = startBorder(map, startRow, startCol, &startDirection);
+    if (status != MAZE_OK)
+        return status;
+    unsigned char *startedFaces = mazeMalloc(cellsSize(map) * sizeof(unsigned char));
+    if (startedFaces == NULL)
+        return MAZE_ERROR_MEMORY;
+    memset(startedFaces, 0, cellsSize(map) * sizeof(unsigned char));
+    // the entry point can be a decision point as well, then both of the inner faces start a corridor
+    for (int j = 0; j < (getCell(map, startRow, startCol) == '0' ? 2 : 1); j++) {
+        chooseFaceToMoveThrow(map, startRow, startCol, &startDirection, 1);
+        MazePoint cMazeP = {{startRow, startCol}, {startRow, startCol}, startDirection, 0, NULL, false, startDirection, false, 0};
+        if (!addMazePointToArray(&mazePointsArr, cMazeP)) {
+            free(startedFaces);
+            freeMazePointsArray(&mazePointsArr);
+            return MAZE_ERROR_MEMORY;
+        }
+        startedFaces[cellIndex(map, startRow, startCol)] |= 1 << startDirection;
+        STAT_INC(decisionPoints);
+    }
 
     enum Sides entryDirection;
     unsigned char cellValue;
     int Row, Col;
     int skipOne;
     int mazePointIdx;
+    bool anyRemoved = false;
 
-    while (1) {
-        mazePointIdx = chooseMazePoint(mazePointsArr);
-        if (mazePointIdx == -1)
-            break;
+    if (foundExit != NULL)
+        *foundExit = (Point){-1, -1};
+
+    for (mazePointIdx = 0; mazePointIdx < mazePointsArr.mazePointsCount; mazePointIdx++) {
 
         // move to the next decision point
         Row = mazePointsArr.mazePoints[mazePointIdx].startPoint.row;
         Col = mazePointsArr.mazePoints[mazePointIdx].startPoint.col;
-        skipOne = moveToNextDecisionPoint(map, &Row, &Col, &mazePointsArr.mazePoints[mazePointIdx]);
+        skipOne = moveToNextDecisionPoint(map, &Row, &Col, &mazePointsArr.mazePoints[mazePointIdx], storeMoves);
         cellValue = getCell(map, Row, Col);
+        if (foundExit != NULL && skipOne == 0 && (Row != startRow || Col != startCol)) { // the corridor leads out of the maze
+            *foundExit = (Point){Row, Col};
+            break;
+        }
         // in case we are not out of the map, we will add two new mazepoints to the queue, which are connected to the current mazepoint
         if (cellValue != '?' && skipOne == 1) {
             entryDirection = mazePointsArr.mazePoints[mazePointIdx].currentDir;
@@ -698,235 +1152,2290 @@ MazePointsArray simplifyMaze(Map *map, int startRow, int startCol) {
                     chooseFaceToMoveThrow(map, Row, Col, &entryDirection, 1);
                 MazePoint newMazePoint1 = {
                     mazePointsArr.mazePoints[mazePointIdx].endPoint, 
-                    {-1, -1}, entryDirection, 1, NULL, false
+                    {-1, -1}, entryDirection, 1, NULL, false, entryDirection, false, 0
                     };
-                addMazePointToArray(&mazePointsArr, newMazePoint1);
+                unsigned char *faces = &startedFaces[cellIndex(map, Row, Col)];
+                if (!(*faces & (1 << entryDirection))) {
+                    if (!addMazePointToArray(&mazePointsArr, newMazePoint1)) {
+                        free(startedFaces);
+                        freeMazePointsArray(&mazePointsArr);
+                        return MAZE_ERROR_MEMORY;
+                    }
+                    *faces |= 1 << entryDirection;
+                    STAT_INC(decisionPoints);
+                }
             }
         } else if (skipOne == -1) {
-            removeMazePoint(&mazePointsArr, mazePointIdx);
+            anyRemoved = true; // stays unfinished, removed below
+        }
+    }
+    free(startedFaces);
+    if (anyRemoved) {
+        int kept = 0;
+        for (int i = 0; i < mazePointsArr.mazePointsCount; i++) {
+            if (mazePointsArr.mazePoints[i].finished || i > mazePointIdx)
+                mazePointsArr.mazePoints[kept++] = mazePointsArr.mazePoints[i];
         }
+        mazePointsArr.mazePointsCount = kept;
     }
-    return mazePointsArr;
+    *result = mazePointsArr;
+    return MAZE_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
-// A* algorithem
+// MAZE GRAPH - START INDEPENDENT SIMPLIFICATION
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
- * @brief - finds the conection points of the current maze point
- * @param - Point startPoint
+ * @brief - returns the side, the maze is entered throw in the cell (the same as startBorder)
+ * @param - Map struct
+ * @param - int row
+ * @param - int col
+ * @return - int, enum Sides, -1 if the cell is not an entry point
+ * @note - the sides are checked in the order of findEntryPoints
+ */
+static int entrySideOfCell(Map *map, int row, int col) {
+    if (row == 1 && !cellPointingUp(row, col) && !isBorder(map, row, col, STRAIGHT))
+        return STRAIGHT;
+    if (col == map->cols && !isBorder(map, row, col, DIAGONAL_RIGHT))
+        return DIAGONAL_RIGHT;
+    if (row == map->rows && cellPointingUp(row, col) && !isBorder(map, row, col, STRAIGHT))
+        return STRAIGHT;
+    if (col == 1 && !isBorder(map, row, col, DIAGONAL_LEFT))
+        return DIAGONAL_LEFT;
+    return -1;
+}
+
+/**
+ * @brief - traces the corridor leaving the cell throw the side and adds it to the array
+ * @param - Map struct
  * @param - MazePointsArray struct
- * @param - int resultArray[2], array to store the indexes
- * @return - void
+ * @param - int row
+ * @param - int col
+ * @param - enum Sides side
+ * @param - bool storeMoves
+ * @return - bool, false if the memory cannot be allocated
+ * @note - corridors leading back to the cell they start in are not added (as in simplifyMaze)
  */
-void findConectionPoints(Point startPoint, MazePointsArray* mazePointsArray, int resultArray[2]) {
-    MazePoint comprasonPoint;
-    int counter = 0;
+static bool traceGraphCorridor(Map *map, MazePointsArray *array, int row, int col, enum Sides side, bool storeMoves) {
+    MazePoint corridor = {{row, col}, {row, col}, side, 0, NULL, false, side, false, 0};
+    if (moveToNextDecisionPoint(map, &row, &col, &corridor, storeMoves) == -1)
+        return true;
+    if (addMazePointToArray(array, corridor))
+        return true;
+    free(corridor.moveThrowFaces);
+    return false;
+}
 
-    for (int i = 0; i < mazePointsArray->mazePointsCount; i++) {
-        comprasonPoint = mazePointsArray->mazePoints[i];
-        if (comprasonPoint.startPoint.row == startPoint.row && comprasonPoint.startPoint.col == startPoint.col) {
-            resultArray[counter++] = i;
+/**
+ * @brief - traces all the corridors, that start in the rows of the band
+ * @param - void* arg, GraphBand struct
+ * @return - void* NULL
+ * @note - the corridors are followed over the band borders, the map is only read
+ */
+static void *buildGraphBand(void *arg) {
+    GraphBand *band = arg;
+    Map *map = band->map;
+    int side;
+
+    band->status = MAZE_OK;
+    for (int row = band->firstRow; row <= band->lastRow; row++) {
+        for (int col = 1; col <= map->cols; col++) {
+            if (getCell(map, row, col) == '0') { // decision point, every face starts a corridor
+                for (side = DIAGONAL_LEFT; side <= STRAIGHT; side++) {
+                    if (!traceGraphCorridor(map, &band->corridors, row, col, side, band->storeMoves))
+                        band->status = MAZE_ERROR_MEMORY;
+                }
+                continue;
+            }
+            side = entrySideOfCell(map, row, col);
+            if (side == -1)
+                continue;
+            enum Sides startDirection = side;
+            chooseFaceToMoveThrow(map, row, col, &startDirection, 1);
+            if (!traceGraphCorridor(map, &band->corridors, row, col, startDirection, band->storeMoves))
+                band->status = MAZE_ERROR_MEMORY;
         }
-        if (counter == 2)
+        if (band->status != MAZE_OK)
             break;
     }
-    for (int i = counter; i < 2; i++) {
-        resultArray[i] = -1;
-    }
-}   
+    return NULL;
+}
+
+/**
+ * @brief - builds the graph of all the corridors in the maze, independent of the start point
+ * @param - Map struct
+ * @param - bool storeMoves, whether to store the faces moved throw (reconstructPath walks the corridors without them again)
+ * @param - MazePointsArray* graph, sorted by the start point and the first face, empty on error
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - the rows are split into bands, each band is traced by its own thread
+ */
+enum MazeStatus buildMazeGraph(Map *map, bool storeMoves, MazePointsArray *graph) {
+    long bandsCount = sysconf(_SC_NPROCESSORS_ONLN);
+    bandsCount = bandsCount > map->rows ? map->rows : bandsCount;
+    bandsCount = bandsCount < 1 ? 1 : bandsCount; // one (empty) band for a map without rows
+    GraphBand bands[bandsCount];
+    pthread_t threads[bandsCount];
+    bool threadStarted[bandsCount];
+
+    for (int b = 0; b < bandsCount; b++) {
+        bands[b] = (GraphBand){map, b * map->rows / bandsCount + 1, (b + 1) * map->rows / bandsCount, storeMoves, {NULL, 0}, MAZE_OK};
+        threadStarted[b] = pthread_create(&threads[b], NULL, buildGraphBand, &bands[b]) == 0;
+        if (!threadStarted[b]) // trace the band in this thread instead
+            buildGraphBand(&bands[b]);
+    }
+    int count = 0;
+    enum MazeStatus status = MAZE_OK;
+    for (int b = 0; b < bandsCount; b++) {
+        if (threadStarted[b])
+            pthread_join(threads[b], NULL);
+        count += bands[b].corridors.mazePointsCount;
+        if (bands[b].status != MAZE_OK)
+            status = bands[b].status;
+    }
+
+    // join the bands, they are already in the order of the rows
+    *graph = (MazePointsArray){NULL, 0};
+    if (status == MAZE_OK) {
+        graph->mazePoints = mazeMalloc((count + 1) * sizeof(MazePoint));
+        status = graph->mazePoints == NULL ? MAZE_ERROR_MEMORY : MAZE_OK;
+    }
+    if (status != MAZE_OK) {
+        for (int b = 0; b < bandsCount; b++)
+            freeMazePointsArray(&bands[b].corridors);
+        return status;
+    }
+    for (int b = 0; b < bandsCount; b++) {
+        if (bands[b].corridors.mazePointsCount > 0)
+            memcpy(graph->mazePoints + graph->mazePointsCount, bands[b].corridors.mazePoints, bands[b].corridors.mazePointsCount * sizeof(MazePoint));
+        graph->mazePointsCount += bands[b].corridors.mazePointsCount;
+        free(bands[b].corridors.mazePoints);
+    }
+    STAT_ADD(decisionPoints, count);
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the corridor in the graph
+ * @param - MazePointsArray struct, graph from buildMazeGraph
+ * @param - Point startPoint
+ * @param - enum Sides firstDir
+ * @return - int, index of the corridor, -1 if there is no such corridor
+ * @note - binary search, the graph is sorted by the start point and the first face
+ */
+static int findGraphCorridor(MazePointsArray *graph, Point startPoint, enum Sides firstDir) {
+    int low = 0;
+    int high = graph->mazePointsCount - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        MazePoint *corridor = &graph->mazePoints[middle];
+        int compare = corridor->startPoint.row - startPoint.row;
+        if (compare == 0)
+            compare = corridor->startPoint.col - startPoint.col;
+        if (compare == 0)
+            compare = (int)corridor->firstDir - (int)firstDir;
+        if (compare == 0)
+            return middle;
+        if (compare < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief - selects the corridors of the graph, that are reachable from the start point
+ * @param - MazePointsArray struct, graph from buildMazeGraph
+ * @param - Map struct
+ * @param - int startRow
+ * @param - int startCol
+ * @param - MazePointsArray* result, the same corridors in the same order as simplifyMaze returns, empty on error
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY or MAZE_ERROR_MEMORY on error
+ * @note - the moves of the corridors are shared with the graph, free only the array itself
+ */
+enum MazeStatus selectReachableGraph(MazePointsArray *graph, Map *map, int startRow, int startCol, MazePointsArray *result) {
+    MazePointsArray selected = {NULL, 0};
+    *result = selected;
+    enum Sides startDirection;
+    enum MazeStatus status = startBorder(map, startRow, startCol, &startDirection);
+    if (status != MAZE_OK)
+        return status;
+
+    bool *isSelected = mazeMalloc((graph->mazePointsCount + 1) * sizeof(bool));
+    if (isSelected == NULL)
+        return MAZE_ERROR_MEMORY;
+    memset(isSelected, 0, (graph->mazePointsCount + 1) * sizeof(bool));
+
+    // the same start corridors as of simplifyMaze
+    int idx;
+    for (int j = 0; j < (getCell(map, startRow, startCol) == '0' ? 2 : 1) && status == MAZE_OK; j++) {
+        chooseFaceToMoveThrow(map, startRow, startCol, &startDirection, 1);
+        idx = findGraphCorridor(graph, (Point){startRow, startCol}, startDirection);
+        if (idx == -1 || isSelected[idx])
+            continue;
+        isSelected[idx] = true;
+        status = addMazePointToArray(&selected, graph->mazePoints[idx]) ? MAZE_OK : MAZE_ERROR_MEMORY;
+    }
+
+    // the same order as the queue of simplifyMaze, new corridors are added at the end
+    for (int i = 0; i < selected.mazePointsCount && status == MAZE_OK; i++) {
+        MazePoint corridor = selected.mazePoints[i];
+        if (corridor.leavesMap)
+            continue;
+        enum Sides entryDirection = corridor.currentDir;
+        for (int j = 0; j < 2; j++) {
+            if (j == 1)
+                chooseFaceToMoveThrow(map, corridor.endPoint.row, corridor.endPoint.col, &entryDirection, 1);
+            idx = findGraphCorridor(graph, corridor.endPoint, entryDirection);
+            if (idx == -1 || isSelected[idx])
+                continue;
+            isSelected[idx] = true;
+            if (!addMazePointToArray(&selected, graph->mazePoints[idx]))
+                status = MAZE_ERROR_MEMORY;
+        }
+    }
+    free(isSelected);
+    if (status != MAZE_OK) {
+        free(selected.mazePoints);
+        return status;
+    }
+    *result = selected;
+    return MAZE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// A* algorithem
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief - adds the item to the binary heap
+ * @param - RouteHeapItem* heap
+ * @param - int* heapSize
+ * @param - long long distance, priority of the item
+ * @param - int node
+ * @return - void
+ * @note - the items with the same distance are ordered by the node, so the searches are deterministic
+ */
+static void pushRouteHeap(RouteHeapItem *heap, int *heapSize, long long distance, int node) {
+    int idx = (*heapSize)++;
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        RouteHeapItem *parentItem = &heap[parent];
+        if (parentItem->distance < distance || (parentItem->distance == distance && parentItem->node <= node))
+            break;
+        heap[idx] = *parentItem;
+        idx = parent;
+    }
+    heap[idx] = (RouteHeapItem){distance, node};
+}
+
+/**
+ * @brief - removes the item with the lowest distance from the binary heap
+ * @param - RouteHeapItem* heap
+ * @param - int* heapSize
+ * @return - RouteHeapItem, the closest item
+ */
+static RouteHeapItem popRouteHeap(RouteHeapItem *heap, int *heapSize) {
+    RouteHeapItem top = heap[0];
+    RouteHeapItem last = heap[--(*heapSize)];
+    int idx = 0;
+    while (1) {
+        int child = 2 * idx + 1;
+        if (child >= *heapSize)
+            break;
+        if (child + 1 < *heapSize && (heap[child+1].distance < heap[child].distance ||
+            (heap[child+1].distance == heap[child].distance && heap[child+1].node < heap[child].node)))
+            child++;
+        if (last.distance < heap[child].distance || (last.distance == heap[child].distance && last.node <= heap[child].node))
+            break;
+        heap[idx] = heap[child];
+        idx = child;
+    }
+    heap[idx] = last;
+    return top;
+}
+
+/**
+ * @brief - compares the conection entries by the start point, then by the index of the maze point
+ * @param - const void* a
+ * @param - const void* b
+ * @return - int
+ */
+static int compareConectionEntries(const void *a, const void *b) {
+    const ConectionEntry *first = a;
+    const ConectionEntry *second = b;
+    if (first->point.row != second->point.row)
+        return first->point.row < second->point.row ? -1 : 1;
+    if (first->point.col != second->point.col)
+        return first->point.col < second->point.col ? -1 : 1;
+    return (first->idx > second->idx) - (first->idx < second->idx);
+}
+
+/**
+ * @brief - sorts the maze points by their start points, so the conection points are found by a binary search
+ * @param - MazePointsArray struct
+ * @param - ConectionEntry** conectionIndex, the sorted entries (one per maze point)
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ */
+static enum MazeStatus buildConectionIndex(MazePointsArray *mazePointsArray, ConectionEntry **conectionIndex) {
+    *conectionIndex = mazeMalloc((mazePointsArray->mazePointsCount + 1) * sizeof(ConectionEntry));
+    if (*conectionIndex == NULL)
+        return MAZE_ERROR_MEMORY;
+    for (int i = 0; i < mazePointsArray->mazePointsCount; i++)
+        (*conectionIndex)[i] = (ConectionEntry){mazePointsArray->mazePoints[i].startPoint, i};
+    qsort(*conectionIndex, mazePointsArray->mazePointsCount, sizeof(ConectionEntry), compareConectionEntries);
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the conection points of the current maze point
+ * @param - Point startPoint
+ * @param - ConectionEntry* conectionIndex, from buildConectionIndex
+ * @param - int conectionsCount, number of the entries
+ * @param - int resultArray[3], array to store the indexes (in the order of the maze points)
+ * @return - void
+ */
+static void findConectionPoints(Point startPoint, ConectionEntry *conectionIndex, int conectionsCount, int resultArray[3]) {
+    int low = 0;
+    int high = conectionsCount;
+    STAT_INC(conectionScans);
+
+    // the first entry, that does not start before the start point
+    while (low < high) {
+        int middle = (low + high) / 2;
+        Point point = conectionIndex[middle].point;
+        if (point.row < startPoint.row || (point.row == startPoint.row && point.col < startPoint.col))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    int counter = 0;
+    for (int i = low; i < conectionsCount && counter < 3; i++) {
+        if (conectionIndex[i].point.row != startPoint.row || conectionIndex[i].point.col != startPoint.col)
+            break;
+        resultArray[counter++] = conectionIndex[i].idx;
+    }
+    for (int i = counter; i < 3; i++) {
+        resultArray[i] = -1;
+    }
+}
+
+/**
+ * @brief - adds the conection points to the priority queue
+ * @param - int conectionPoints[3], array of indexes of the conection points
+ * @param - MazePointsArray struct
+ * @param - Map struct
+ * @param - Point endPoint
+ * @param - RouteHeapItem* priorityQueue, binary heap of the maze points by the cost so far plus the estimate
+ * @param - int* priorityQueueSize, size of the priority queue
+ * @param - long long* pathCosts, cost of the path up to the end of the maze point, LLONG_MAX if not reached yet
+ * @param - int* parents, array of the maze points, the conection point was reached from
+ * @param - int parentIdx, index of the maze point, the conection points are reached from
+ * @return - void
+ * @note - a point is queued again, if a cheaper path to it is found (the old item is skipped when it is popped)
+ */
+static void addConectionPoints(int conectionPoints[3], MazePointsArray *mazePointsArray, Map *map, Point endPoint, RouteHeapItem *priorityQueue, int *priorityQueueSize, long long *pathCosts, int *parents, int parentIdx) {
+    long long parentCost = parentIdx == -1 ? 0 : pathCosts[parentIdx];
+    for (int i = 0; i < 3; i++) {
+        if (conectionPoints[i] == -1)
+            break;
+        int conectionIdx = conectionPoints[i];
+        MazePoint *conectionPoint = &mazePointsArray->mazePoints[conectionIdx];
+        long long cost = parentCost + conectionPoint->cost;
+        if (cost >= pathCosts[conectionIdx])
+            continue;
+        pathCosts[conectionIdx] = cost;
+        parents[conectionIdx] = parentIdx;
+        // rounded down, so the estimate stays admissible (and consistent) on the whole numbers
+        long long estimate = (long long)(map->minCost * calculateEuklidianDistance(
+            conectionPoint->endPoint.row, 
+            conectionPoint->endPoint.col, 
+            endPoint.row, 
+            endPoint.col
+            ));
+        pushRouteHeap(priorityQueue, priorityQueueSize, cost + estimate, conectionIdx);
+        STAT_INC(astarPushes);
+    }
+}
+
+/**
+ * @brief - runs the a* algorithem between one start and end point
+ * @param - Point startPoint
+ * @param - Point endPoint
+ * @param - MazePointsArray struct
+ * @param - ConectionEntry* conectionIndex, from buildConectionIndex
+ * @param - Map struct
+ * @param - long long maxCost, paths, that cost this much or more are not searched (LLONG_MAX for no limit)
+ * @param - long long* pathLength, pointer to the cost of the path (without the start cell), -1 if the end point cannot be reached
+ * @param - ResultPathArray struct, NULL if only the path length is needed
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - every step costs at least the minimal cost, so the euklidian distance scaled by it never overestimates
+ */
+static enum MazeStatus runAstar(Point startPoint, Point endPoint, MazePointsArray *mazePointsArray, ConectionEntry *conectionIndex, Map *map, long long maxCost, long long *pathLength, ResultPathArray *resultPathArray) {
+    int count = mazePointsArray->mazePointsCount;
+
+    (*pathLength) = -1;
+    if (resultPathArray != NULL) {
+        resultPathArray->pathIdxes = NULL;
+        resultPathArray->pathIdxesCount = -1;
+    }
+    // every maze point has at most 3 conection points, so it is queued at most 3 times
+    RouteHeapItem *priorityQueue = mazeMalloc((3 * count + 3) * sizeof(RouteHeapItem));
+    long long *pathCosts = mazeMalloc((count + 1) * sizeof(long long));
+    int *parents = mazeMalloc((count + 1) * sizeof(int));
+    bool *visited = mazeMalloc((count + 1) * sizeof(bool));
+    if (priorityQueue == NULL || pathCosts == NULL || parents == NULL || visited == NULL) {
+        free(priorityQueue);
+        free(pathCosts);
+        free(parents);
+        free(visited);
+        return MAZE_ERROR_MEMORY;
+    }
+    int priorityQueueSize = 0;
+    for (int i = 0; i < count; i++) {
+        pathCosts[i] = LLONG_MAX;
+        visited[i] = false;
+    }
+
+    int connectionPoints[3];
+    findConectionPoints(startPoint, conectionIndex, count, connectionPoints);
+    addConectionPoints(connectionPoints, mazePointsArray, map, endPoint, priorityQueue, &priorityQueueSize, pathCosts, parents, -1);
+    int foundIdx = -1;
+
+    // in case the queue gets empty, we have gone throw all the connected paths, and none ware the exit point
+    while (priorityQueueSize != 0) {
+        // the maze point with the lowest cost so far plus the estimate to the end point
+        RouteHeapItem item = popRouteHeap(priorityQueue, &priorityQueueSize);
+        if (item.distance >= maxCost)
+            break;
+        int pointIdx = item.node;
+        if (visited[pointIdx])
+            continue;
+        visited[pointIdx] = true;
+        STAT_INC(astarPops);
+        MazePoint *currentMazePoint = &mazePointsArray->mazePoints[pointIdx];
+        // we have found the wanted end point
+        if (currentMazePoint->endPoint.row == endPoint.row && currentMazePoint->endPoint.col == endPoint.col) {
+            foundIdx = pointIdx;
+            break;
+        }
+        findConectionPoints(currentMazePoint->endPoint, conectionIndex, count, connectionPoints);
+        addConectionPoints(connectionPoints, mazePointsArray, map, endPoint, priorityQueue, &priorityQueueSize, pathCosts, parents, pointIdx);
+    }
+
+    // reconstruct the path, going from the end point to the start point, following the parents
+    int *resultPath = NULL;
+    int counter = 0;
+    bool allocated = true;
+
+    for (int idx = foundIdx; resultPathArray != NULL && idx != -1 && allocated; idx = parents[idx])
+        allocated = addToIntArray(&resultPath, &counter, idx);
+    long long length = foundIdx == -1 ? -1 : pathCosts[foundIdx];
+    free(priorityQueue);
+    free(pathCosts);
+    free(parents);
+    free(visited);
+
+    if (!allocated) {
+        free(resultPath);
+        return MAZE_ERROR_MEMORY;
+    }
+    (*pathLength) = length;
+    if (foundIdx != -1 && resultPathArray != NULL) {
+        resultPathArray->pathIdxes = resultPath;
+        resultPathArray->pathIdxesCount = counter;
+    }
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the shortest path in the maze
+ * @param - MazePointsArray struct
+ * @param - Map struct
+ * @param - Point startPoint
+ * @param - long long* shortestLength, cost of the path (number of its cells, if there are no costs), -1 if there is no path
+ * @param - ResultPathArray* shortestPath, the corridors of the path ({NULL, -1} if there is no path), NULL if only the length is needed
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - uses the a* algorithem to find the shortest path, the search for every next exit stops at the cost of the best path so far
+ */
+enum MazeStatus findshortesPath(MazePointsArray *mazePointsArray, Map *map, Point startPoint, long long *shortestLength, ResultPathArray *shortestPath) {
+
+    EntryPointsArray entryPointsArray;
+    EntryPoint currentPoint;
+    ResultPathArray currentShortestPath = {NULL, -1};
+    ResultPathArray bestPath = {NULL, -1};
+    ConectionEntry *conectionIndex;
+
+    long long mindistance = -1;
+    long long currentDistance;
+    // the corridors count the cells they enter, the start cell is not entered
+    int startCost = cellCost(map, startPoint.row, startPoint.col);
+
+    *shortestLength = -1;
+    if (shortestPath != NULL)
+        *shortestPath = bestPath;
+    enum MazeStatus status = findEntryPoints(map, &entryPointsArray);
+    if (status != MAZE_OK)
+        return status;
+    status = buildConectionIndex(mazePointsArray, &conectionIndex);
+    if (status != MAZE_OK)
+        return status;
+
+    // go throw all the entry point, exit point combination, and run the a* algorithem
+    for (int i = 0; i < entryPointsArray.entryPointsCount; i++) {
+        currentPoint = entryPointsArray.entryPoints[i];
+
+        if (currentPoint.row == startPoint.row && currentPoint.col == startPoint.col) // skip start == end ..
+            continue;
+
+        Point endPoint = {currentPoint.row, currentPoint.col};
+        long long maxCost = mindistance == -1 ? LLONG_MAX : mindistance - startCost;
+        status = runAstar(startPoint, endPoint, mazePointsArray, conectionIndex, map, maxCost, &currentDistance, shortestPath != NULL ? &currentShortestPath : NULL);
+        if (status != MAZE_OK)
+            break;
+        if (currentDistance == -1) // no result form a* (or not shorter than the best path)
+            continue;
+        currentDistance += startCost;
+
+        if (currentDistance < mindistance || mindistance == -1) { //in case the path is shorter than the previous one, save it
+            mindistance = currentDistance;
+            free(bestPath.pathIdxes);
+            bestPath = currentShortestPath;
+        } else {
+            free(currentShortestPath.pathIdxes);
+        }
+   }
+   free(conectionIndex);
+   if (status != MAZE_OK) {
+       free(bestPath.pathIdxes);
+       return status;
+   }
+   *shortestLength = mindistance;
+   if (shortestPath != NULL)
+       *shortestPath = bestPath;
+   return MAZE_OK;
+}
+
+/**
+ * @brief - reconstructs the path form the shortest path array, after the a* algorithem
+ * @param - ResultPathArray struct
+ * @param - MazePointsArray struct
+ * @param - Map struct
+ * @param - Point startPoint
+ * @param - FILE* output, stream the path is printed to
+ * @return - void
+ * @note - corridors without stored moves are walked again on the map (the same walk as moveToNextDecisionPoint)
+ */
+void reconstructPath(ResultPathArray *shortestPath, MazePointsArray *mazePointArray, Map *map, Point StartPoint, FILE *output) {
+
+    int currentRow = StartPoint.row;
+    int currentCol = StartPoint.col;
+    int endRow, endCol;
+    enum Sides currentDir, walkDir;
+    MazePoint *corridor;
+
+    fprintf(output, "%d,%d\n", currentRow, currentCol);
+    for (int i = shortestPath->pathIdxesCount-1; i >= 0; i--) {
+        corridor = &mazePointArray->mazePoints[shortestPath->pathIdxes[i]];
+        endRow = corridor->endPoint.row;
+        endCol = corridor->endPoint.col;
+        walkDir = corridor->firstDir;
+        for (int j = 0; j < corridor->distance; j++) {
+            if (currentRow == endRow && currentCol == endCol) 
+                break;
+            currentDir = corridor->moveThrowFaces != NULL ? corridor->moveThrowFaces[j] : walkDir;
+            moveDirection(&currentRow, &currentCol, &currentDir);
+            fprintf(output, "%d,%d\n", currentRow, currentCol);
+            if (corridor->moveThrowFaces == NULL) {
+                walkDir = currentDir;
+                chooseFaceToMoveThrow(map, currentRow, currentCol, &walkDir, 1);
+            }
+        }
+    }   
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// CELL SEARCH - breadth first search over the cells, without the graph
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#define CELL_UNVISITED 0xFF
+#define CELL_START 3
+
+/**
+ * @brief - adds the point to the end of the queue, the ring buffer is doubled when it is full
+ * @param - CellQueue* queue
+ * @param - Point point
+ * @return - bool, false if the memory cannot be allocated
+ */
+static bool pushCellQueue(CellQueue *queue, Point point) {
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity == 0 ? CELL_QUEUE_MIN_CAPACITY : 2 * queue->capacity;
+        Point *points = mazeMalloc(capacity * sizeof(Point));
+        if (points == NULL)
+            return false;
+        // unwrap the ring, the first point is at the start again
+        for (int i = 0; i < queue->count; i++)
+            points[i] = queue->points[(queue->head + i) & (queue->capacity - 1)];
+        free(queue->points);
+        queue->points = points;
+        queue->capacity = capacity;
+        queue->head = 0;
+    }
+    queue->points[(queue->head + queue->count) & (queue->capacity - 1)] = point;
+    queue->count++;
+    return true;
+}
+
+/**
+ * @brief - removes the first point of the queue
+ * @param - CellQueue* queue, not empty
+ * @return - Point
+ */
+static Point popCellQueue(CellQueue *queue) {
+    Point point = queue->points[queue->head];
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->count--;
+    return point;
+}
+
+/**
+ * @brief - finds the shortest path to the closest exit by a breadth first search over the cells
+ * @param - Map struct
+ * @param - Point startPoint
+ * @param - int* shortestLength, number of the cells of the path, -1 if there is no path
+ * @param - FILE* output, stream the path is printed to, NULL if only the length is needed
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY or MAZE_ERROR_MEMORY on error
+ * @note - one byte per cell keeps the side every cell was entered throw (it leads back to the start),
+ *         all the exits are searched at once, the costs of the cells are not taken into account,
+ *         of the equally close exits the first one in the order of findEntryPoints is taken (as findshortesPath does)
+ */
+enum MazeStatus findShortestPathBfs(Map *map, Point startPoint, int *shortestLength, FILE *output) {
+    enum Sides entrySide;
+    *shortestLength = -1;
+    enum MazeStatus status = startBorder(map, startPoint.row, startPoint.col, &entrySide);
+    if (status != MAZE_OK)
+        return status;
+
+    unsigned char *entrySides = mazeMalloc(cellsSize(map) * sizeof(unsigned char));
+    CellQueue queue = {NULL, 0, 0, 0};
+    if (entrySides == NULL || !pushCellQueue(&queue, startPoint)) {
+        free(entrySides);
+        free(queue.points);
+        return MAZE_ERROR_MEMORY;
+    }
+    memset(entrySides, CELL_UNVISITED, cellsSize(map) * sizeof(unsigned char));
+    entrySides[cellIndex(map, startPoint.row, startPoint.col)] = CELL_START;
+
+    // the queue is searched level by level, the level is the distance from the start
+    int level = 0;
+    int levelRemaining = 1;
+    Point exitPoint = {-1, -1};
+    int exitPosition = -1;
+    while (queue.count > 0 && status == MAZE_OK) {
+        Point point = popCellQueue(&queue);
+        int walls = map->cells[cellIndex(map, point.row, point.col)] - '0';
+        for (int side = DIAGONAL_LEFT; side <= STRAIGHT; side++) {
+            if ((walls >> side) & 0x01)
+                continue;
+            Point next = point;
+            enum Sides nextSide = side;
+            moveDirection(&next.row, &next.col, &nextSide);
+            if (next.row < 1 || next.row > map->rows || next.col < 1 || next.col > map->cols) {
+                int position = entryPosition(map, point.row, point.col);
+                bool isStart = point.row == startPoint.row && point.col == startPoint.col; // the entry point is not an exit
+                if (!isStart && (exitPosition == -1 || position < exitPosition)) {
+                    exitPoint = point;
+                    exitPosition = position;
+                }
+                continue;
+            }
+            if (exitPoint.row != -1) // the rest of the level is only checked for exits
+                continue;
+            size_t idx = cellIndex(map, next.row, next.col);
+            if (entrySides[idx] != CELL_UNVISITED)
+                continue;
+            entrySides[idx] = nextSide;
+            if (!pushCellQueue(&queue, next)) {
+                status = MAZE_ERROR_MEMORY;
+                break;
+            }
+        }
+        if (--levelRemaining == 0) {
+            if (exitPoint.row != -1)
+                break;
+            level++;
+            levelRemaining = queue.count;
+        }
+    }
+    free(queue.points);
+
+    // walk back to the start, throw the sides the cells were entered throw
+    Point *path = NULL;
+    if (status == MAZE_OK && exitPoint.row != -1 && output != NULL) {
+        path = mazeMalloc((level + 1) * sizeof(Point));
+        if (path == NULL)
+            status = MAZE_ERROR_MEMORY;
+    }
+    if (path != NULL) {
+        Point point = exitPoint;
+        for (int i = level; i >= 0; i--) {
+            path[i] = point;
+            enum Sides side = entrySides[cellIndex(map, point.row, point.col)];
+            if (side != CELL_START)
+                moveDirection(&point.row, &point.col, &side);
+        }
+        for (int i = 0; i <= level; i++)
+            fprintf(output, "%d,%d\n", path[i].row, path[i].col);
+        free(path);
+    }
+    free(entrySides);
+    if (status == MAZE_OK && exitPoint.row != -1)
+        *shortestLength = level + 1;
+    return status;
+}
+
+/**
+ * @brief - chooses the engine of the shortest path for the map
+ * @param - Map struct
+ * @param - enum ShortestEngine engine, ENGINE_AUTO to choose by the map
+ * @return - enum ShortestEngine, ENGINE_BFS or ENGINE_GRAPH
+ * @note - small maps, maps with many decision points (short corridors) and all maps on one processor
+ *         (the graph is traced in parallel bands) are searched cell by cell, maps with costs need the graph,
+ *         the decision points are counted on at most 2^16 cells spread over the map
+ */
+enum ShortestEngine chooseShortestEngine(Map *map, enum ShortestEngine engine) {
+    if (map->costs != NULL)
+        return ENGINE_GRAPH;
+    if (engine != ENGINE_AUTO)
+        return engine;
+    long cells = (long)map->rows * map->cols;
+    if (cells <= BFS_ENGINE_MAX_CELLS || sysconf(_SC_NPROCESSORS_ONLN) <= 1)
+        return ENGINE_BFS;
+
+    long stride = cells / BFS_ENGINE_MAX_CELLS;
+    long sampled = 0;
+    long junctions = 0;
+    for (long i = 0; i < cells; i += stride) {
+        junctions += getCell(map, i / map->cols + 1, i % map->cols + 1) == '0';
+        sampled++;
+    }
+    return junctions * 100 >= sampled * BFS_ENGINE_MIN_JUNCTIONS_PERCENT ? ENGINE_BFS : ENGINE_GRAPH;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// K SHORTEST PATHS - Yen's algorithem over the maze graph
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief - adds a route to the array
+ * @param - GraphRoutesArray struct
+ * @param - GraphRoute element
+ * @return - bool, false if the memory cannot be reallocated (the array is left unchanged)
+ */
+static bool addRouteToArray(GraphRoutesArray *array, GraphRoute element) {
+    if (array->routesCount % 10 == 0) {
+        GraphRoute *newArray = mazeRealloc(array->routes, (array->routesCount + 10) * sizeof(GraphRoute));
+        if (newArray == NULL)
+            return false;
+        array->routes = newArray;
+    }
+    array->routes[array->routesCount++] = element;
+    return true;
+}
+
+/**
+ * @brief - frees the routes array
+ * @param - GraphRoutesArray struct
+ * @return - void
+ */
+void freeGraphRoutesArray(GraphRoutesArray *array) {
+    for (int i = 0; i < array->routesCount; i++)
+        free(array->routes[i].path.pathIdxes);
+    free(array->routes);
+}
+
+/**
+ * @brief - returns the corridor of the route, counted from the start
+ * @param - GraphRoute* route
+ * @param - int idx
+ * @return - int, index of the corridor in the graph
+ */
+static inline int routeCorridor(GraphRoute *route, int idx) {
+    return route->path.pathIdxes[route->path.pathIdxesCount - 1 - idx];
+}
+
+/**
+ * @brief - finds the node of the point
+ * @param - RouteSearch struct
+ * @param - Point point
+ * @return - int, node, -1 if no corridor starts in the point
+ * @note - binary search, the graph is sorted by the start point
+ */
+static int findRouteNode(RouteSearch *search, Point point) {
+    int low = 0;
+    int high = search->nodesCount - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        Point nodePoint = search->graph->mazePoints[search->firstCorridorOfNode[middle]].startPoint;
+        int compare = nodePoint.row != point.row ? nodePoint.row - point.row : nodePoint.col - point.col;
+        if (compare == 0)
+            return middle;
+        if (compare < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief - frees the route search
+ * @param - RouteSearch struct
+ * @return - void
+ */
+static void freeRouteSearch(RouteSearch *search) {
+    free(search->firstCorridorOfNode);
+    free(search->endNodeOfCorridor);
+    free(search->bannedCorridors);
+    free(search->bannedNodes);
+    free(search->distances);
+    free(search->parents);
+    free(search->heap);
+}
+
+/**
+ * @brief - prepares the nodes of the graph for the route search
+ * @param - RouteSearch* search
+ * @param - MazePointsArray struct, graph from buildMazeGraph
+ * @param - Point startPoint, the routes do not leave the maze throw it
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ */
+static enum MazeStatus initRouteSearch(RouteSearch *search, MazePointsArray *graph, Point startPoint) {
+    int corridorsCount = graph->mazePointsCount;
+    *search = (RouteSearch){graph, startPoint, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0};
+    search->firstCorridorOfNode = mazeMalloc((corridorsCount + 1) * sizeof(int));
+    search->endNodeOfCorridor = mazeMalloc((corridorsCount + 1) * sizeof(int));
+    search->bannedCorridors = mazeMalloc((corridorsCount + 1) * sizeof(bool));
+    search->bannedNodes = mazeMalloc((corridorsCount + 1) * sizeof(bool));
+    search->distances = mazeMalloc((corridorsCount + 1) * sizeof(long long));
+    search->parents = mazeMalloc((corridorsCount + 1) * sizeof(int));
+    search->heap = mazeMalloc((corridorsCount + 1) * sizeof(RouteHeapItem));
+    if (search->firstCorridorOfNode == NULL || search->endNodeOfCorridor == NULL || search->bannedCorridors == NULL ||
+        search->bannedNodes == NULL || search->distances == NULL || search->parents == NULL || search->heap == NULL) {
+        freeRouteSearch(search);
+        return MAZE_ERROR_MEMORY;
+    }
+    memset(search->bannedCorridors, 0, (corridorsCount + 1) * sizeof(bool));
+    memset(search->bannedNodes, 0, (corridorsCount + 1) * sizeof(bool));
+
+    // the corridors of one start point are next to each other in the graph
+    for (int i = 0; i < corridorsCount; i++) {
+        Point point = graph->mazePoints[i].startPoint;
+        if (i == 0 || point.row != graph->mazePoints[i-1].startPoint.row || point.col != graph->mazePoints[i-1].startPoint.col)
+            search->firstCorridorOfNode[search->nodesCount++] = i;
+    }
+    search->firstCorridorOfNode[search->nodesCount] = corridorsCount;
+    for (int i = 0; i < corridorsCount; i++) {
+        MazePoint *corridor = &graph->mazePoints[i];
+        search->endNodeOfCorridor[i] = corridor->leavesMap ? -1 : findRouteNode(search, corridor->endPoint);
+        // a corner decision point can be left throw two faces, the route is the same
+        for (int j = i - 1; j >= 0 && corridor->leavesMap; j--) {
+            MazePoint *previous = &graph->mazePoints[j];
+            if (previous->startPoint.row != corridor->startPoint.row || previous->startPoint.col != corridor->startPoint.col)
+                break;
+            if (previous->leavesMap && search->endNodeOfCorridor[j] == -1 && previous->distance == corridor->distance &&
+                previous->endPoint.row == corridor->endPoint.row && previous->endPoint.col == corridor->endPoint.col)
+                search->endNodeOfCorridor[i] = -2;
+        }
+    }
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the shortest route from the node to any exit, avoiding the banned nodes and corridors (dijkstra)
+ * @param - RouteSearch* search
+ * @param - int sourceNode
+ * @param - GraphRoute* route, the found route (length -1 if there is none)
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ */
+static enum MazeStatus findSpurRoute(RouteSearch *search, int sourceNode, GraphRoute *route) {
+    MazePointsArray *graph = search->graph;
+    int bestCorridor = -1;
+    long long bestLength = LLONG_MAX;
+
+    *route = (GraphRoute){{NULL, 0}, -1, 0};
+    for (int i = 0; i < search->nodesCount; i++) {
+        search->distances[i] = LLONG_MAX;
+        search->parents[i] = -1;
+    }
+    search->distances[sourceNode] = 0;
+    search->heapSize = 0;
+    pushRouteHeap(search->heap, &search->heapSize, 0, sourceNode);
+
+    while (search->heapSize > 0) {
+        RouteHeapItem item = popRouteHeap(search->heap, &search->heapSize);
+        if (item.distance > search->distances[item.node])
+            continue;
+        if (item.distance >= bestLength)
+            break;
+        for (int i = search->firstCorridorOfNode[item.node]; i < search->firstCorridorOfNode[item.node+1]; i++) {
+            MazePoint *corridor = &graph->mazePoints[i];
+            long long length = item.distance + corridor->cost;
+            if (search->bannedCorridors[i] || search->endNodeOfCorridor[i] == -2)
+                continue;
+            if (corridor->leavesMap) { // an exit, unless it is the entry point
+                bool isStart = corridor->endPoint.row == search->startPoint.row && corridor->endPoint.col == search->startPoint.col;
+                if (!isStart && length < bestLength) {
+                    bestLength = length;
+                    bestCorridor = i;
+                }
+                continue;
+            }
+            int next = search->endNodeOfCorridor[i];
+            if (next == -1 || search->bannedNodes[next] || length >= search->distances[next])
+                continue;
+            search->distances[next] = length;
+            search->parents[next] = i;
+            pushRouteHeap(search->heap, &search->heapSize, length, next);
+            STAT_INC(astarPushes);
+        }
+        STAT_INC(astarPops);
+    }
+    if (bestCorridor == -1)
+        return MAZE_OK;
+
+    // the corridors are stored from the exit back to the source node
+    int node = -1;
+    for (int idx = bestCorridor; idx != -1; idx = search->parents[node]) {
+        if (!addToIntArray(&route->path.pathIdxes, &route->path.pathIdxesCount, idx)) {
+            free(route->path.pathIdxes);
+            *route = (GraphRoute){{NULL, 0}, -1, 0};
+            return MAZE_ERROR_MEMORY;
+        }
+        node = findRouteNode(search, graph->mazePoints[idx].startPoint);
+        if (node == sourceNode)
+            break;
+    }
+    route->length = bestLength;
+    return MAZE_OK;
+}
+
+/**
+ * @brief - checks whether the route is already in the array
+ * @param - GraphRoutesArray struct
+ * @param - GraphRoute* route
+ * @return - bool
+ */
+static bool routeExists(GraphRoutesArray *array, GraphRoute *route) {
+    for (int i = 0; i < array->routesCount; i++) {
+        ResultPathArray *path = &array->routes[i].path;
+        if (path->pathIdxesCount == route->path.pathIdxesCount &&
+            memcmp(path->pathIdxes, route->path.pathIdxes, path->pathIdxesCount * sizeof(int)) == 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief - finds the spur routes of the route, that leave it at or after its deviation corridor
+ * @param - RouteSearch* search
+ * @param - GraphRoutesArray* found, routes found so far
+ * @param - GraphRoute* route, the last found route
+ * @param - int startNode
+ * @param - GraphRoutesArray* candidates
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - the spurs before the deviation were already searched from the parent route (Lawler)
+ */
+static enum MazeStatus addSpurCandidates(RouteSearch *search, GraphRoutesArray *found, GraphRoute *route, int startNode, GraphRoutesArray *candidates) {
+    MazePointsArray *graph = search->graph;
+    long long rootLength = search->startCost;
+    int spurNode = startNode;
+
+    for (int i = 0; i < route->deviation; i++) {
+        rootLength += graph->mazePoints[routeCorridor(route, i)].cost;
+        spurNode = search->endNodeOfCorridor[routeCorridor(route, i)];
+    }
+    for (int i = route->deviation; i < route->path.pathIdxesCount; i++) {
+        // the routes with the same root can not leave the spur node the same way again
+        for (int j = 0; j < found->routesCount; j++) {
+            GraphRoute *other = &found->routes[j];
+            bool sameRoot = other->path.pathIdxesCount > i;
+            for (int c = 0; c < i && sameRoot; c++)
+                sameRoot = routeCorridor(other, c) == routeCorridor(route, c);
+            if (sameRoot)
+                search->bannedCorridors[routeCorridor(other, i)] = true;
+        }
+        // the route must not return to the nodes of the root
+        search->bannedNodes[startNode] = spurNode != startNode;
+        for (int c = 0; c < i - 1; c++)
+            search->bannedNodes[search->endNodeOfCorridor[routeCorridor(route, c)]] = true;
+
+        GraphRoute spur;
+        enum MazeStatus status = findSpurRoute(search, spurNode, &spur);
+
+        memset(search->bannedCorridors, 0, graph->mazePointsCount * sizeof(bool));
+        memset(search->bannedNodes, 0, search->nodesCount * sizeof(bool));
+        if (status != MAZE_OK)
+            return status;
+
+        if (spur.length != -1) { // the candidate is the root followed by the spur
+            GraphRoute candidate = {spur.path, rootLength + spur.length, i};
+            for (int c = i - 1; c >= 0 && status == MAZE_OK; c--) {
+                if (!addToIntArray(&candidate.path.pathIdxes, &candidate.path.pathIdxesCount, routeCorridor(route, c)))
+                    status = MAZE_ERROR_MEMORY;
+            }
+            if (status == MAZE_OK && !routeExists(candidates, &candidate)) {
+                if (addRouteToArray(candidates, candidate))
+                    candidate.path.pathIdxes = NULL; // owned by the candidates now
+                else
+                    status = MAZE_ERROR_MEMORY;
+            }
+            free(candidate.path.pathIdxes);
+            if (status != MAZE_OK)
+                return status;
+        }
+        rootLength += graph->mazePoints[routeCorridor(route, i)].cost;
+        spurNode = search->endNodeOfCorridor[routeCorridor(route, i)];
+    }
+    return MAZE_OK;
+}
+
+/**
+ * @brief - finds the k shortest loopless routes from the entry point to any exit
+ * @param - MazePointsArray struct, graph from buildMazeGraph
+ * @param - Map struct
+ * @param - Point startPoint
+ * @param - int k
+ * @param - GraphRoutesArray* routes, the routes from the shortest one (less than k, if there are not enough routes)
+ * @return - enum MazeStatus, MAZE_ERROR_NOT_ENTRY or MAZE_ERROR_MEMORY on error
+ * @note - Yen's algorithem, no route visits a decision point twice
+ */
+enum MazeStatus findKShortestRoutes(MazePointsArray *graph, Map *map, Point startPoint, int k, GraphRoutesArray *routes) {
+    *routes = (GraphRoutesArray){NULL, 0};
+    enum Sides entrySide;
+    enum MazeStatus status = startBorder(map, startPoint.row, startPoint.col, &entrySide);
+    if (status != MAZE_OK)
+        return status;
+
+    RouteSearch search;
+    status = initRouteSearch(&search, graph, startPoint);
+    if (status != MAZE_OK)
+        return status;
+    int startNode = findRouteNode(&search, startPoint);
+    search.startCost = cellCost(map, startPoint.row, startPoint.col);
+    GraphRoutesArray candidates = {NULL, 0};
+
+    GraphRoute route = {{NULL, 0}, -1, 0};
+    if (startNode != -1 && k > 0)
+        status = findSpurRoute(&search, startNode, &route);
+    if (route.length != -1)
+        route.length += search.startCost;
+    if (route.length != -1 && !addRouteToArray(routes, route)) {
+        free(route.path.pathIdxes);
+        status = MAZE_ERROR_MEMORY;
+    }
+    while (status == MAZE_OK && routes->routesCount > 0 && routes->routesCount < k) {
+        status = addSpurCandidates(&search, routes, &routes->routes[routes->routesCount-1], startNode, &candidates);
+        if (status != MAZE_OK || candidates.routesCount == 0)
+            break;
+        // the shortest candidate is the next route (the first found one of the same length)
+        int best = 0;
+        for (int i = 1; i < candidates.routesCount; i++) {
+            if (candidates.routes[i].length < candidates.routes[best].length)
+                best = i;
+        }
+        if (!addRouteToArray(routes, candidates.routes[best])) {
+            status = MAZE_ERROR_MEMORY;
+            break;
+        }
+        memmove(candidates.routes + best, candidates.routes + best + 1, (candidates.routesCount - best - 1) * sizeof(GraphRoute));
+        candidates.routesCount--;
+    }
+    freeGraphRoutesArray(&candidates);
+    freeRouteSearch(&search);
+    if (status != MAZE_OK) {
+        freeGraphRoutesArray(routes);
+        *routes = (GraphRoutesArray){NULL, 0};
+    }
+    return status;
+}
+
+#ifndef MAZE_LIBRARY // the generator, the rendering and the benchmark are used only by the command line interface
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// MAZE GENERATOR
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+enum MazeKind { // declare the kinds of generated mazes
+    MAZE_PERFECT,
+    MAZE_LOOPS,
+    MAZE_OPEN,
+    MAZE_SERPENTINE
+};
+
+static const char *mazeKindNames[] = {"perfect", "loops", "open", "serpentine"};
+
+/**
+ * @brief - returns a pseudo random number (xorshift64)
+ * @param - unsigned long long* state, seed of the generator, must not be 0
+ * @return - unsigned long long random number
+ */
+static unsigned long long nextRandom(unsigned long long *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * @brief - converts the name of the maze kind to the enum
+ * @param - char* name
+ * @return - int, enum MazeKind, -1 if the name is unknown
+ */
+static int parseMazeKind(char *name) {
+    for (int i = 0; i < (int)(sizeof(mazeKindNames) / sizeof(mazeKindNames[0])); i++) {
+        if (strcmp(name, mazeKindNames[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief - removes the wall on the side of the cell, as well as the wall of the neighbouring cell
+ * @param - Map struct
+ * @param - int row
+ * @param - int col
+ * @param - enum Sides side
+ * @return - void
+ * @note - if the neighbour is outside the map, only the wall of the cell is removed (entry point), the cached entry points are dropped
+ */
+static void carveWall(Map *map, int row, int col, enum Sides side) {
+    size_t idx = cellIndex(map, row, col);
+    map->cells[idx] = '0' + ((map->cells[idx] - '0') & ~(1 << side));
+
+    int neighbourRow = row;
+    int neighbourCol = col;
+    enum Sides neighbourSide = side;
+    moveDirection(&neighbourRow, &neighbourCol, &neighbourSide);
+    if (getCell(map, neighbourRow, neighbourCol) == '?') {
+        freePerimeter(map); // the entry points have changed
+        return;
+    }
+    idx = cellIndex(map, neighbourRow, neighbourCol);
+    map->cells[idx] = '0' + ((map->cells[idx] - '0') & ~(1 << neighbourSide));
+}
+
+/**
+ * @brief - carves a perfect maze (spanning tree) using the sidewinder algorithem
+ * @param - Map struct, all walls set
+ * @param - unsigned long long* seed
+ * @return - void
+ * @note - the first row is one corridor, every other row is split into runs, 
+ *         each run is connected to the row above throw one cell pointing down
+ */
+static void carvePerfectMaze(Map *map, unsigned long long *seed) {
+    for (int col = 1; col < map->cols; col++)
+        carveWall(map, 1, col, DIAGONAL_RIGHT);
+
+    for (int row = 2; row <= map->rows; row++) {
+        int runStart = 1;
+        for (int col = 1; col <= map->cols; col++) {
+            int firstDown = runStart + (cellPointingUp(row, runStart) ? 1 : 0);
+            bool closeRun = col == map->cols || nextRandom(seed) % 2 == 0;
+
+            if (closeRun && firstDown > col) { // run without a cell, that can go up
+                if (col != map->cols) {
+                    carveWall(map, row, col, DIAGONAL_RIGHT);
+                    continue;
+                }
+                carveWall(map, row, col, DIAGONAL_LEFT); // join the last cell to the previous run
+                break;
+            }
+            if (!closeRun) {
+                carveWall(map, row, col, DIAGONAL_RIGHT);
+                continue;
+            }
+            int downCount = (col - firstDown) / 2 + 1;
+            int upCol = firstDown + 2 * (int)(nextRandom(seed) % downCount);
+            carveWall(map, row, upCol, STRAIGHT);
+            runStart = col + 1;
+        }
+    }
+}
+
+/**
+ * @brief - removes the interior walls of the maze with a given probability
+ * @param - Map struct
+ * @param - unsigned long long* seed
+ * @param - int percent, probability of removing a wall
+ * @return - void
+ */
+static void carveInteriorWalls(Map *map, unsigned long long *seed, int percent) {
+    for (int row = 1; row <= map->rows; row++) {
+        for (int col = 1; col <= map->cols; col++) {
+            if (col != map->cols && (int)(nextRandom(seed) % 100) < percent)
+                carveWall(map, row, col, DIAGONAL_RIGHT);
+            if (cellPointingUp(row, col) && row != map->rows && (int)(nextRandom(seed) % 100) < percent)
+                carveWall(map, row, col, STRAIGHT);
+        }
+    }
+}
+
+/**
+ * @brief - carves one corridor, winding throw all the rows of the maze
+ * @param - Map struct
+ * @return - void
+ * @note - odd rows continue to the next row on the right side, even rows on the left side
+ */
+static void carveSerpentineMaze(Map *map) {
+    for (int row = 1; row <= map->rows; row++) {
+        for (int col = 1; col < map->cols; col++)
+            carveWall(map, row, col, DIAGONAL_RIGHT);
+        if (row == map->rows)
+            break;
+        int col = (row % 2 == 1) ? map->cols : 1;
+        if (!cellPointingUp(row, col))
+            col += (row % 2 == 1) ? -1 : 1;
+        carveWall(map, row, col, STRAIGHT);
+    }
+}
+
+/**
+ * @brief - generates a valid maze
+ * @param - int rows
+ * @param - int cols, at least 2
+ * @param - enum MazeKind kind
+ * @param - unsigned long long seed
+ * @param - enum CellLayout layout, of the cells
+ * @return - Map struct, cells are NULL if the memory cannot be allocated
+ * @note - the entry is the left side of 1,1, the exit is the right side of the last cell
+ */
+static Map generateMaze(int rows, int cols, enum MazeKind kind, unsigned long long seed, enum CellLayout layout) {
+    Map map = {rows, cols, NULL, LAYOUT_ROW_MAJOR, NULL, 1, NULL};
+    if (!allocateCells(&map, layout))
+        return map;
+    memset(map.cells, '7', cellsSize(&map));
+    seed = seed == 0 ? 0x9E3779B97F4A7C15ULL : seed;
+
+    switch (kind) {
+        case MAZE_PERFECT:
+            carvePerfectMaze(&map, &seed);
+            break;
+        case MAZE_LOOPS:
+            carvePerfectMaze(&map, &seed);
+            carveInteriorWalls(&map, &seed, 10);
+            break;
+        case MAZE_OPEN:
+            carveInteriorWalls(&map, &seed, 100);
+            break;
+        case MAZE_SERPENTINE:
+            carveSerpentineMaze(&map);
+            break;
+    }
+    carveWall(&map, 1, 1, DIAGONAL_LEFT);
+    carveWall(&map, rows, cols, DIAGONAL_RIGHT);
+    return map;
+}
+
+/**
+ * @brief - writes the maze in the format accepted by loadMaze
+ * @param - Map struct
+ * @param - FILE* output
+ * @return - void
+ */
+static void writeMaze(Map *map, FILE *output) {
+    fprintf(output, "%d %d\n", map->rows, map->cols);
+    for (int i = 0; i < map->rows; i++) {
+        for (int j = 0; j < map->cols; j++) {
+            fputc(getCell(map, i+1, j+1), output);
+            fputc(j == map->cols-1 ? '\n' : ' ', output);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// RENDERING - the maze and the paths as a ppm or svg image, streamed by bands of rows
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#define RENDER_CELL_WIDTH 8 // pixels of the straight face of a cell
+#define RENDER_CELL_HEIGHT 7 // pixels of a row, about an equilateral triangle
+#define RENDER_BAND_BYTES (1 << 22) // size of the image of the rows rasterised by one thread at a time
+#define PATH_RPATH 0x01 // marks of the cells on the rendered paths
+#define PATH_LPATH 0x02
+#define PATH_SHORTEST 0x04
+
+enum RenderFormat { // declare the formats of the rendered image
+    RENDER_PPM,
+    RENDER_SVG
+};
+
+// color of the cells by their marks (the paths mix), right hand blue and left hand red as in the readme images
+static const unsigned char renderColors[8][3] = {
+    {255, 255, 255}, {60, 90, 230}, {230, 60, 60}, {190, 60, 210},
+    {60, 190, 80}, {40, 190, 200}, {220, 190, 40}, {120, 120, 120}
+};
+static const unsigned char renderWallColor[3] = {0, 0, 0};
+
+typedef struct {
+    Map *map;
+    const unsigned char *marks;
+    enum RenderFormat format;
+    int firstRow;
+    int lastRow; // firstRow - 1 if the band is empty
+    char *output; // the image of the rows
+    size_t outputSize;
+    enum MazeStatus status;
+} RenderBand;
+
+/**
+ * @brief - marks the cells of the printed path
+ * @param - Map struct
+ * @param - FILE* path, the path as printed by the solvers ("row,col" lines), read from the current position
+ * @param - unsigned char mark, PATH_RPATH, PATH_LPATH or PATH_SHORTEST
+ * @param - unsigned char* marks, marks of the cells (the same layout as the cells)
+ * @return - void
+ * @note - the cells outside of the map are skipped
+ */
+static void markPathCells(Map *map, FILE *path, unsigned char mark, unsigned char *marks) {
+    int row, col;
+    while (fscanf(path, "%d,%d", &row, &col) == 2) {
+        if (row >= 1 && row <= map->rows && col >= 1 && col <= map->cols)
+            marks[cellIndex(map, row, col)] |= mark;
+    }
+}
+
+/**
+ * @brief - rasterises the rows of the band, one pixel row after another
+ * @param - RenderBand* band
+ * @param - FILE* output
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - the pixel is in the cell right of the diagonal of its half cell column, or in the left one,
+ *         it is a wall if it is closer than a pixel to a closed face (the diagonals are compared squared)
+ */
+static enum MazeStatus renderPpmBand(RenderBand *band, FILE *output) {
+    Map *map = band->map;
+    const int halfWidth = RENDER_CELL_WIDTH / 2;
+    const int height = RENDER_CELL_HEIGHT;
+    const double diagonalLimit = (double)(halfWidth * halfWidth + height * height) / (height * height);
+    size_t width = (size_t)(map->cols + 1) * halfWidth;
+    unsigned char *pixels = mazeMalloc(width * 3 + 1);
+    if (pixels == NULL)
+        return MAZE_ERROR_MEMORY;
+
+    for (int row = band->firstRow; row <= band->lastRow; row++) {
+        for (int y = 0; y < height; y++) {
+            double t = (y + 0.5) / height; // 0 at the top of the row, 1 at the bottom
+            for (size_t x = 0; x < width; x++) {
+                double u = (x + 0.5) / halfWidth; // the cell col spans u from col-1 to col+1
+                int col = (int)u + 1;
+                double frac = u - (int)u;
+                if (frac < (cellPointingUp(row, col) ? 1 - t : t))
+                    col--;
+                const unsigned char *color = renderColors[0];
+                if (col >= 1 && col <= map->cols) {
+                    bool pointsUp = cellPointingUp(row, col);
+                    int walls = getCell(map, row, col) - '0';
+                    double left = (u - (pointsUp ? col - t : col - 1 + t)) * halfWidth;
+                    double right = ((pointsUp ? col + t : col + 1 - t) - u) * halfWidth;
+                    double straight = (pointsUp ? 1 - t : t) * height;
+                    if (((walls >> DIAGONAL_LEFT) & 0x01 && left * left < diagonalLimit) ||
+                        ((walls >> DIAGONAL_RIGHT) & 0x01 && right * right < diagonalLimit) ||
+                        ((walls >> STRAIGHT) & 0x01 && straight < 1))
+                        color = renderWallColor;
+                    else
+                        color = renderColors[band->marks[cellIndex(map, row, col)] & 0x07];
+                }
+                memcpy(&pixels[x * 3], color, 3);
+            }
+            fwrite(pixels, 1, width * 3, output);
+        }
+    }
+    free(pixels);
+    return MAZE_OK;
+}
+
+/**
+ * @brief - writes the rows of the band as svg, the marked cells as polygons and the walls of every row as one path
+ * @param - RenderBand* band
+ * @param - FILE* output
+ * @return - enum MazeStatus, MAZE_OK
+ */
+static enum MazeStatus renderSvgBand(RenderBand *band, FILE *output) {
+    Map *map = band->map;
+    const int halfWidth = RENDER_CELL_WIDTH / 2;
+    for (int row = band->firstRow; row <= band->lastRow; row++) {
+        int top = (row - 1) * RENDER_CELL_HEIGHT;
+        int bottom = row * RENDER_CELL_HEIGHT;
+        for (int col = 1; col <= map->cols; col++) {
+            int mark = band->marks[cellIndex(map, row, col)] & 0x07;
+            if (mark == 0)
+                continue;
+            int apex = cellPointingUp(row, col) ? top : bottom;
+            int base = cellPointingUp(row, col) ? bottom : top;
+            fprintf(output, "<polygon points=\"%d,%d %d,%d %d,%d\" fill=\"#%02x%02x%02x\"/>\n", col * halfWidth, apex,
+                (col - 1) * halfWidth, base, (col + 1) * halfWidth, base, renderColors[mark][0], renderColors[mark][1], renderColors[mark][2]);
+        }
+        bool anyWall = false;
+        for (int col = 1; col <= map->cols; col++) {
+            int walls = getCell(map, row, col) - '0';
+            int apex = cellPointingUp(row, col) ? top : bottom;
+            int base = cellPointingUp(row, col) ? bottom : top;
+            if (walls != 0 && !anyWall) {
+                fprintf(output, "<path stroke=\"#000\" fill=\"none\" d=\"");
+                anyWall = true;
+            }
+            if ((walls >> DIAGONAL_LEFT) & 0x01)
+                fprintf(output, "M%d %dL%d %d", (col - 1) * halfWidth, base, col * halfWidth, apex);
+            if ((walls >> DIAGONAL_RIGHT) & 0x01)
+                fprintf(output, "M%d %dL%d %d", col * halfWidth, apex, (col + 1) * halfWidth, base);
+            if ((walls >> STRAIGHT) & 0x01)
+                fprintf(output, "M%d %dL%d %d", (col - 1) * halfWidth, base, (col + 1) * halfWidth, base);
+        }
+        if (anyWall)
+            fprintf(output, "\"/>\n");
+    }
+    return MAZE_OK;
+}
+
+/**
+ * @brief - renders the band into its own memory stream
+ * @param - void* arg, RenderBand struct
+ * @return - void* NULL
+ */
+static void *renderBand(void *arg) {
+    RenderBand *band = arg;
+    FILE *output = open_memstream(&band->output, &band->outputSize);
+    if (output == NULL) {
+        band->status = MAZE_ERROR_MEMORY;
+        return NULL;
+    }
+    band->status = band->format == RENDER_PPM ? renderPpmBand(band, output) : renderSvgBand(band, output);
+    if (ferror(output))
+        band->status = MAZE_ERROR_MEMORY;
+    fclose(output);
+    return NULL;
+}
+
+/**
+ * @brief - renders the maze with the marked cells
+ * @param - Map struct
+ * @param - const unsigned char* marks, PATH_RPATH, PATH_LPATH and PATH_SHORTEST of every cell (the same layout as the cells)
+ * @param - enum RenderFormat format
+ * @param - FILE* output
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY or MAZE_ERROR_FILE (the image cannot be written) on error
+ * @note - the rows are split into bands of about RENDER_BAND_BYTES, every thread renders one band, the bands
+ *         are written in order and freed before the next ones, so the image is never held in the memory
+ */
+static enum MazeStatus renderMaze(Map *map, const unsigned char *marks, enum RenderFormat format, FILE *output) {
+    long width = (long)(map->cols + 1) * (RENDER_CELL_WIDTH / 2);
+    long height = (long)map->rows * RENDER_CELL_HEIGHT;
+    if (format == RENDER_PPM) {
+        fprintf(output, "P6\n%ld %ld\n255\n", width, height);
+    } else {
+        fprintf(output, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%ld\" height=\"%ld\" viewBox=\"0 0 %ld %ld\">\n", width, height, width, height);
+        fprintf(output, "<rect width=\"100%%\" height=\"100%%\" fill=\"#fff\"/>\n");
+    }
+
+    long bandRows = RENDER_BAND_BYTES / (width * 3 * RENDER_CELL_HEIGHT);
+    bandRows = bandRows < 1 ? 1 : bandRows;
+    long threadsCount = sysconf(_SC_NPROCESSORS_ONLN);
+    threadsCount = threadsCount < 1 ? 1 : threadsCount;
+    pthread_t threads[threadsCount];
+    bool threadStarted[threadsCount];
+    RenderBand bands[threadsCount];
+    enum MazeStatus status = MAZE_OK;
+
+    for (long firstRow = 1; firstRow <= map->rows && status == MAZE_OK; firstRow += threadsCount * bandRows) {
+        for (int t = 0; t < threadsCount; t++) {
+            long bandFirst = firstRow + t * bandRows;
+            long bandLast = bandFirst + bandRows - 1 > map->rows ? map->rows : bandFirst + bandRows - 1;
+            bands[t] = (RenderBand){map, marks, format, (int)bandFirst, (int)(bandLast < bandFirst ? bandFirst - 1 : bandLast), NULL, 0, MAZE_OK};
+            threadStarted[t] = pthread_create(&threads[t], NULL, renderBand, &bands[t]) == 0;
+            if (!threadStarted[t]) // render the band in this thread instead
+                renderBand(&bands[t]);
+        }
+        for (int t = 0; t < threadsCount; t++) {
+            if (threadStarted[t])
+                pthread_join(threads[t], NULL);
+        }
+        for (int t = 0; t < threadsCount; t++) {
+            if (bands[t].status != MAZE_OK)
+                status = bands[t].status;
+            else if (status == MAZE_OK)
+                fwrite(bands[t].output, 1, bands[t].outputSize, output);
+            free(bands[t].output);
+        }
+    }
+    if (format == RENDER_SVG)
+        fprintf(output, "</svg>\n");
+    if (status == MAZE_OK && ferror(output))
+        status = MAZE_ERROR_FILE;
+    return status;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// BENCHMARK
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    const char *name;
+    double seconds;
+    unsigned long allocations;
+    unsigned long reallocations;
+} BenchPhase;
+
+/**
+ * @brief - returns the monotonic time in seconds
+ * @return - double seconds
+ */
+static double getTimeSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief - returns the peak resident set size of the process
+ * @return - long, peak RSS in kilobytes
+ * @note - the peak never drops, run_bench measures every maze in its own child process
+ */
+static long getPeakRssKb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief - starts measuring a benchmark phase
+ * @param - BenchPhase* phase
+ * @param - const char* name
+ * @return - void
+ */
+static void beginBenchPhase(BenchPhase *phase, const char *name) {
+    phase->name = name;
+    phase->allocations = allocationCounters.allocations;
+    phase->reallocations = allocationCounters.reallocations;
+    phase->seconds = getTimeSeconds();
+}
+
+/**
+ * @brief - stops measuring a benchmark phase
+ * @param - BenchPhase* phase
+ * @return - void
+ */
+static void endBenchPhase(BenchPhase *phase) {
+    phase->seconds = getTimeSeconds() - phase->seconds;
+    phase->allocations = allocationCounters.allocations - phase->allocations;
+    phase->reallocations = allocationCounters.reallocations - phase->reallocations;
+}
+
+/**
+ * @brief - benchmarks all the phases of the solver on one generated maze
+ * @param - enum MazeKind kind
+ * @param - int rows
+ * @param - int cols
+ * @param - enum CellLayout layout, of the cells
+ * @param - FILE* devNull, stream for the output of the solver
+ * @return - bool, false if the maze could not be generated or loaded
+ * @note - prints one json object per line to the stdout
+ */
+static bool benchMaze(enum MazeKind kind, int rows, int cols, enum CellLayout layout, FILE *devNull) {
+    char fileName[] = "/tmp/maze_bench_XXXXXX";
+    int fd = mkstemp(fileName);
+    if (fd == -1)
+        return false;
+    FILE *file = fdopen(fd, "w");
+    if (file == NULL) {
+        close(fd);
+        unlink(fileName);
+        return false;
+    }
+    Map generated = generateMaze(rows, cols, kind, 42, layout);
+    if (generated.cells == NULL) {
+        fclose(file);
+        unlink(fileName);
+        return false;
+    }
+    writeMaze(&generated, file);
+    fclose(file);
+    freeMap(generated);
+
+    BenchPhase phases[6];
+    Map map;
+    beginBenchPhase(&phases[0], "loadMaze");
+    enum MazeStatus status = loadMaze(fileName, &map, layout);
+    endBenchPhase(&phases[0]);
+    unlink(fileName);
+    if (status != MAZE_OK)
+        return false;
+
+    beginBenchPhase(&phases[1], "checkMazeValidity");
+    bool valid = checkMazeValidity(map);
+    endBenchPhase(&phases[1]);
+
+    beginBenchPhase(&phases[2], "solve_maze");
+    status = solve_maze(&map, 0, 1, 1, devNull);
+    endBenchPhase(&phases[2]);
+
+    // the moves are not stored (the paths are walked again when printed), the simplified maze is freed before the graph is built
+    beginBenchPhase(&phases[3], "simplifyMaze");
+    MazePointsArray mazePointsArray = {NULL, 0};
+    if (status == MAZE_OK)
+        status = simplifyMaze(&map, 1, 1, false, NULL, &mazePointsArray);
+    endBenchPhase(&phases[3]);
+    int decisionPoints = mazePointsArray.mazePointsCount;
+
+    beginBenchPhase(&phases[5], "findshortesPath");
+    ResultPathArray shortestPath = {NULL, -1};
+    long long shortestLength;
+    if (status == MAZE_OK && mazePointsArray.mazePointsCount > 1)
+        status = findshortesPath(&mazePointsArray, &map, (Point){1, 1}, &shortestLength, &shortestPath);
+    endBenchPhase(&phases[5]);
+    free(shortestPath.pathIdxes);
+    freeMazePointsArray(&mazePointsArray);
+
+    beginBenchPhase(&phases[4], "buildMazeGraph");
+    MazePointsArray mazeGraph = {NULL, 0};
+    if (status == MAZE_OK)
+        status = buildMazeGraph(&map, false, &mazeGraph);
+    endBenchPhase(&phases[4]);
+    freeMazePointsArray(&mazeGraph);
+
+    if (status != MAZE_OK) {
+        freeMap(map);
+        return false;
+    }
+
+    long cells = (long)rows * cols;
+    printf("{\"kind\":\"%s\",\"rows\":%d,\"cols\":%d,\"cells\":%ld,\"layout\":\"%s\",\"valid\":%s,\"decisionPoints\":%d,\"phases\":{",
+        mazeKindNames[kind], rows, cols, cells, map.layout == LAYOUT_TILED ? "tiled" : "row",
+        valid ? "true" : "false", decisionPoints);
+    for (int i = 0; i < 6; i++) {
+        printf("%s\"%s\":{\"seconds\":%.9f,\"cellsPerSecond\":%.1f",
+            i == 0 ? "" : ",", phases[i].name, phases[i].seconds,
+            phases[i].seconds > 0 ? cells / phases[i].seconds : 0.0);
+        printf(",\"allocations\":%lu,\"reallocations\":%lu}", phases[i].allocations, phases[i].reallocations);
+    }
+    printf("},\"peakRssKb\":%ld}\n", getPeakRssKb());
+    fflush(stdout);
+
+    freeMap(map);
+    return true;
+}
+
+/**
+ * @brief - benchmarks one maze in a forked child process, so its peak RSS is not the one of the bigger mazes before it
+ * @param - enum MazeKind kind
+ * @param - int rows
+ * @param - int cols
+ * @param - enum CellLayout layout, of the cells
+ * @param - FILE* devNull, stream for the output of the solver
+ * @return - bool, false if the maze could not be benchmarked
+ * @note - the child starts with the RSS of the parent at the fork, the maze is benchmarked in this process if fork fails
+ */
+static bool benchMazeInChild(enum MazeKind kind, int rows, int cols, enum CellLayout layout, FILE *devNull) {
+    fflush(NULL); // the child must not print the buffered output again
+    pid_t pid = fork();
+    if (pid == -1)
+        return benchMaze(kind, rows, cols, layout, devNull);
+    if (pid == 0) {
+        bool benchmarked = benchMaze(kind, rows, cols, layout, devNull);
+        fflush(stdout);
+        _exit(benchmarked ? 0 : 1);
+    }
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR)
+            return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief - runs the benchmark suite
+ * @param - long maxCells, the biggest maze size (10^2 ... 10^7)
+ * @param - enum CellLayout layout, of the cells
+ * @return - void
+ * @note - every maze kind is benchmarked for every power of ten up to maxCells, the open maze of 10^7 cells peaks at about 3 GB
+ */
+static void run_bench(long maxCells, enum CellLayout layout) {
+    allocationCounters.enabled = true;
+    FILE *devNull = fopen("/dev/null", "w");
+    if (devNull == NULL) {
+        fprintf(stderr, "Error: cannot open /dev/null!\n");
+        return;
+    }
+    for (long cells = 100; cells <= maxCells && cells <= BENCH_MAX_CELLS; cells *= 10) {
+        int rows = 1;
+        while ((long)rows * rows * 100 <= cells) // rows = 10^(floor(log10(cells) / 2))
+            rows *= 10;
+        int cols = cells / rows;
+        for (int kind = MAZE_PERFECT; kind <= MAZE_SERPENTINE; kind++) {
+            if (!benchMazeInChild(kind, rows, cols, layout, devNull))
+                fprintf(stderr, "Error: cannot benchmark %s maze of %ld cells!\n", mazeKindNames[kind], cells);
+        }
+    }
+    fclose(devNull);
+}
+
+/**
+ * @brief - generates a maze and prints it to the stdout
+ * @param - char* kindName
+ * @param - int R (rows)
+ * @param - int C (colunms)
+ * @param - unsigned long long seed
+ * @return - int, exit code
+ */
+static int run_generate(char *kindName, int R, int C, unsigned long long seed) {
+    int kind = parseMazeKind(kindName);
+    if (kind == -1 || R < 1 || C < 2) {
+        fprintf(stderr, "Error: invalid maze kind or size!\n");
+        return 1;
+    }
+    Map map = generateMaze(R, C, kind, seed, LAYOUT_ROW_MAJOR);
+    if (map.cells == NULL) {
+        fprintf(stderr, "Memory allocation error.\n");
+        return 1;
+    }
+    writeMaze(&map, stdout);
+    freeMap(map);
+    return 0;
+}
+
+#endif // MAZE_LIBRARY
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// DIFFERENTIAL VERIFICATION - every engine against a breadth first search over the cells
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#if !defined(MAZE_LIBRARY) || defined(MAZE_FUZZ) // the fuzz entry point verifies its inputs
+
+typedef struct {
+    long mazes;
+    long entryPoints;
+    long mismatches;
+} VerifyCounters;
+
+/**
+ * @brief - finds the length of the shortest path by a breadth first search over the cells
+ * @param - Map struct, valid maze
+ * @param - int row, int col (entry point)
+ * @param - int* length, number of the cells of the path, -1 if no other exit can be reached
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - the reference for every engine, it knows nothing about corridors, decision points or the cell layout
+ */
+static enum MazeStatus bfsShortestLength(Map *map, int row, int col, int *length) {
+    int cells = map->rows * map->cols;
+    int *distances = mazeMalloc((cells + 1) * sizeof(int));
+    int *queue = mazeMalloc((cells + 1) * sizeof(int));
+    *length = -1;
+    if (distances == NULL || queue == NULL) {
+        free(distances);
+        free(queue);
+        return MAZE_ERROR_MEMORY;
+    }
+    for (int i = 0; i < cells; i++)
+        distances[i] = -1;
+    int head = 0;
+    int tail = 0;
+    distances[(row-1)*map->cols + (col-1)] = 0;
+    queue[tail++] = (row-1)*map->cols + (col-1);
+
+    // the cells are taken in the order of their distance, the first one with an exit is the closest
+    while (head < tail && *length == -1) {
+        int idx = queue[head++];
+        int currentRow = idx / map->cols + 1;
+        int currentCol = idx % map->cols + 1;
+        for (int side = 0; side < 3; side++) {
+            if (isBorder(map, currentRow, currentCol, side))
+                continue;
+            int nextRow = currentRow;
+            int nextCol = currentCol;
+            enum Sides nextSide = side;
+            moveDirection(&nextRow, &nextCol, &nextSide);
+            if (getCell(map, nextRow, nextCol) == '?') {
+                if (currentRow != row || currentCol != col) { // the entry point is not an exit
+                    *length = distances[idx] + 1;
+                    break;
+                }
+                continue;
+            }
+            int next = (nextRow-1)*map->cols + (nextCol-1);
+            if (distances[next] != -1)
+                continue;
+            distances[next] = distances[idx] + 1;
+            queue[tail++] = next;
+        }
+    }
+    free(distances);
+    free(queue);
+    return MAZE_OK;
+}
+
+
+/**
+ * @brief - walks the wall follower one face at a time, as the solver did before the tables
+ * @param - Map struct
+ * @param - int leftRight, the same as of solve_maze
+ * @param - int row, int col (entry point)
+ * @param - FILE* output, stream the path is printed to
+ * @param - Point* end, the cell the walk ended in (out of the map at the exit, or the entry point)
+ * @return - bool, false if the walk neither left the map nor returned to the entry point
+ */
+static bool referenceWalk(Map *map, int leftRight, int row, int col, FILE *output, Point *end) {
+    enum Sides side;
+    if (startBorder(map, row, col, &side) != MAZE_OK)
+        return true;
+    fprintf(output, "%d,%d\n", row, col);
+    int currentRow = row;
+    int currentCol = col;
+    // every cell can be entered throw 3 faces, after that the walk repeats
+    for (long steps = 0; steps <= 3L * map->rows * map->cols; steps++) {
+        chooseFaceToMoveThrow(map, currentRow, currentCol, &side, leftRight);
+        moveDirection(&currentRow, &currentCol, &side);
+        if (getCell(map, currentRow, currentCol) == '?' || (currentRow == row && currentCol == col)) {
+            *end = (Point){currentRow, currentCol};
+            return true;
+        }
+        fprintf(output, "%d,%d\n", currentRow, currentCol);
+    }
+    return false;
+}
 
 /**
- * @brief - adds the conection points to the priority queue
- * @param - int conectionPoints[2], array of indexes of the conection points
- * @param - int* priorityQueueSize, size of the priority queue
- * @param - int** priorityQueue, pointer to the priority queue
- * @return - void
+ * @brief - checks if the cell has an open face leading out of the map
+ * @param - Map struct
+ * @param - int row
+ * @param - int col
+ * @return - bool
  */
-void addConectionPoints(int conectionPoints[2], int *priorityQueueSize, int **priorityQueue) {
-    int conectionIdx;
-    for (int i = 0; i < 2; i++) {
-        if (conectionPoints[i] == -1)
-            break;
-        conectionIdx = conectionPoints[i];
-        addToIntArray(priorityQueue, priorityQueueSize, conectionIdx);
-    }
+static bool hasOpeningOut(Map *map, int row, int col) {
+    if (col == 1 && !isBorder(map, row, col, DIAGONAL_LEFT))
+        return true;
+    if (col == map->cols && !isBorder(map, row, col, DIAGONAL_RIGHT))
+        return true;
+    if (cellPointingUp(row, col))
+        return row == map->rows && !isBorder(map, row, col, STRAIGHT);
+    return row == 1 && !isBorder(map, row, col, STRAIGHT);
 }
 
 /**
- * @brief - runs the a* algorithem between one start and end point
- * @param - Point startPoint
- * @param - Point endPoint
- * @param - MazePointsArray struct
- * @param - int* pathLength, pointer to the path length
- * @param - ResultPathArray struct
- * @return - void
+ * @brief - checks, that the printed path goes from the entry point throw open faces to an exit
+ * @param - Map struct
+ * @param - int row, int col (entry point)
+ * @param - char* path, printed path, one "row,col" per line
+ * @param - int length, expected number of the cells
+ * @return - bool
  */
-void runAstar(Point startPoint, Point endPoint, MazePointsArray *mazePointsArray, int *pathLength, ResultPathArray *resultPathArray) {
-    int *priorityQueue = NULL;
-    int priorityQueueSize = 0;
-
-    int *visited = NULL;
-    int visitedSize = 0;
-
-    int connectionPoints[2];
-    findConectionPoints(startPoint, mazePointsArray, connectionPoints);
-    addConectionPoints(connectionPoints, &priorityQueueSize, &priorityQueue);
-    MazePoint currentMazePoint;
-
-    double minDistance, distance;
-    int currentIdx;
-
-    while (1) {
-        // in this case, we have gone throw all the connected paths, and none ware the exit point
-        if (priorityQueueSize == 0) { 
-            free(priorityQueue);
-            free(visited); 
-            resultPathArray->pathIdxes = NULL;
-            resultPathArray->pathIdxesCount = -1;
-            return;
-        }
-        // find the maze point with the shortest distance to the end point
-        currentIdx = 0;
-        currentMazePoint = mazePointsArray->mazePoints[priorityQueue[0]];
-        distance = calculateEuklidianDistance(
-            currentMazePoint.endPoint.row, 
-            currentMazePoint.endPoint.col, 
-            endPoint.row, 
-            endPoint.col
-            );
-        minDistance = currentMazePoint.distance + distance;
-
-        for (int i = 1; i < priorityQueueSize; i++) {
-            currentMazePoint = mazePointsArray->mazePoints[priorityQueue[i]];
-            distance = currentMazePoint.distance + calculateEuklidianDistance(
-                currentMazePoint.endPoint.row, 
-                currentMazePoint.endPoint.col, 
-                endPoint.row, 
-                endPoint.col
-                );
-            if (distance < minDistance) {
-                minDistance = distance;
-                currentIdx = i;
+static bool checkPrintedPath(Map *map, int row, int col, char *path, int length) {
+    int count = 0;
+    int currentRow = -1, currentCol = -1;
+    int nextRow, nextCol, read;
+
+    while (sscanf(path, "%d,%d\n%n", &nextRow, &nextCol, &read) == 2) {
+        path += read;
+        if (count == 0 && (nextRow != row || nextCol != col))
+            return false;
+        if (count != 0) {
+            bool neighbours = false;
+            for (int side = 0; side < 3 && !neighbours; side++) {
+                int movedRow = currentRow;
+                int movedCol = currentCol;
+                enum Sides movedSide = side;
+                moveDirection(&movedRow, &movedCol, &movedSide);
+                neighbours = !isBorder(map, currentRow, currentCol, side) && movedRow == nextRow && movedCol == nextCol;
             }
+            if (!neighbours)
+                return false;
         }
-        // remove current mazepoint form the priority queue, as well as add the points, this point is connected to
-        currentMazePoint = mazePointsArray->mazePoints[priorityQueue[currentIdx]];
-        addToIntArray(&visited, &visitedSize, priorityQueue[currentIdx]);
-        findConectionPoints((Point){
-            currentMazePoint.endPoint.row, 
-            currentMazePoint.endPoint.col
-            }, mazePointsArray, connectionPoints);
-
-        addConectionPoints(connectionPoints, &priorityQueueSize, &priorityQueue);
-        removeIntAtIndexFromArray(priorityQueue, &priorityQueueSize, currentIdx);
-        // we have found the wanted end point
-        if (currentMazePoint.endPoint.row == endPoint.row && currentMazePoint.endPoint.col == endPoint.col) 
-            break;
+        currentRow = nextRow;
+        currentCol = nextCol;
+        count++;
     }
-    MazePoint pivot = mazePointsArray->mazePoints[visited[visitedSize-1]];
-    (*pathLength) = pivot.distance;
-    MazePoint cMazeP;
-
-    // reconstruct the path, going from the end point to the start point, finding the next connecting point
-    int *resultPath = NULL;
-    int counter = 0;
+    return count == length && (count == 1 || hasOpeningOut(map, currentRow, currentCol));
+}
 
-    addToIntArray(&resultPath, &counter, visited[visitedSize-1]);
+/**
+ * @brief - reports the mismatch of an engine on the stdout
+ * @param - VerifyCounters* counters
+ * @param - const char* label, the maze the engine was run on
+ * @param - int row, int col (entry point)
+ * @param - const char* engine
+ * @param - long long expected
+ * @param - long long found
+ * @return - void
+ */
+static void reportMismatch(VerifyCounters *counters, const char *label, int row, int col, const char *engine, long long expected, long long found) {
+    printf("mismatch: %s, entry %d,%d, %s: expected %lld, found %lld\n", label, row, col, engine, expected, found);
+    counters->mismatches++;
+}
 
-    while (1) {
-        if (pivot.startPoint.row == startPoint.row && pivot.startPoint.col == startPoint.col) 
-            break;
-        int i;
-        for (i = visitedSize-1; i >= 0; i--) { 
-            cMazeP = mazePointsArray->mazePoints[visited[i]];
-            if (cMazeP.endPoint.row == pivot.startPoint.row && cMazeP.endPoint.col == pivot.startPoint.col) {
-                pivot = cMazeP;
-                (*pathLength) += cMazeP.distance;
+/**
+ * @brief - compares the wall followers against the reference walk
+ * @param - Map struct
+ * @param - int row, int col (entry point)
+ * @param - const char* label
+ * @param - VerifyCounters* counters
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ */
+static enum MazeStatus verifyWalks(Map *map, int row, int col, const char *label, VerifyCounters *counters) {
+    for (int leftRight = 0; leftRight < 2; leftRight++) {
+        char *outputs[2] = {NULL, NULL};
+        size_t sizes[2];
+        bool finished = true;
+        enum MazeStatus status = MAZE_OK, walkStatus = MAZE_OK;
+        Point expectedEnd = {-1, -1};
+        for (int i = 0; i < 2 && status == MAZE_OK; i++) {
+            FILE *output = open_memstream(&outputs[i], &sizes[i]);
+            if (output == NULL) {
+                status = MAZE_ERROR_MEMORY;
                 break;
             }
+            if (i == 0)
+                finished = referenceWalk(map, leftRight, row, col, output, &expectedEnd);
+            else
+                walkStatus = solve_maze(map, leftRight, row, col, output);
+            fclose(output);
+        }
+        if (walkStatus == MAZE_ERROR_MEMORY)
+            status = walkStatus;
+        if (status == MAZE_OK && !finished)
+            reportMismatch(counters, label, row, col, leftRight == 0 ? "reference walk (right), steps" : "reference walk (left), steps", 0, -1);
+        if (status == MAZE_OK && finished != (walkStatus != MAZE_ERROR_ENDLESS))
+            reportMismatch(counters, label, row, col, leftRight == 0 ? "table walk (right), ended" : "table walk (left), ended", finished, !finished);
+        else if (status == MAZE_OK && strcmp(outputs[0], outputs[1]) != 0) {
+            printf("mismatch: %s, entry %d,%d, table walk (%s): differs from the reference walk\n", label, row, col, leftRight == 0 ? "right" : "left");
+            counters->mismatches++;
+        }
+        for (int i = 0; i < 2; i++)
+            free(outputs[i]);
+        if (status != MAZE_OK)
+            return status;
+        // without output the corridors are jumped over, the first walk remembers them, the second one uses them
+        enum Sides entrySide;
+        for (int i = 0; i < 2 && finished && startBorder(map, row, col, &entrySide) == MAZE_OK; i++) {
+            Point end = {-1, -1};
+            if (leftRight == 0)
+                walkStatus = followRightHand(map, row, col, entrySide, NULL, &end);
+            else
+                walkStatus = followLeftHand(map, row, col, entrySide, NULL, &end);
+            if (walkStatus != MAZE_OK || end.row != expectedEnd.row || end.col != expectedEnd.col) {
+                printf("mismatch: %s, entry %d,%d, walk with jumps (%s): ends at %d,%d instead of %d,%d\n", label, row, col,
+                    leftRight == 0 ? "right" : "left", end.row, end.col, expectedEnd.row, expectedEnd.col);
+                counters->mismatches++;
+            }
         }
-       addToIntArray(&resultPath, &counter, visited[i]);
     }
-    free(visited);
-    free(priorityQueue);
+    return MAZE_OK;
+}
 
-    resultPathArray->pathIdxes = resultPath;
-    resultPathArray->pathIdxesCount = counter;
-    return;
+/**
+ * @brief - returns the border position of the last cell of the printed path
+ * @param - Map struct
+ * @param - char* path, "row,col" lines
+ * @return - int, entryPosition of the cell, -1 if the path is empty or does not end at an entry point
+ */
+static int printedExitPosition(Map *map, char *path) {
+    int row = -1, col = -1, read;
+    while (sscanf(path, "%d,%d\n%n", &row, &col, &read) == 2)
+        path += read;
+    return entryPosition(map, row, col);
 }
 
 /**
- * @brief - finds the shortest path in the maze
- * @param - MazePointsArray struct
+ * @brief - compares the shortest path engines against the reference breadth first search over the cells
  * @param - Map struct
- * @param - Point startPoint
- * @return - ResultPathArray struct
- * @note - uses the a* algorithem to find the shortest path
+ * @param - MazePointsArray struct, graph of the maze from buildMazeGraph
+ * @param - int row, int col (entry point)
+ * @param - const char* label
+ * @param - VerifyCounters* counters
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ * @note - engines: simplifyMaze + a*, the graph + a* (with the printed path), k shortest routes (k = 1), reachability
  */
-ResultPathArray findshortesPath(MazePointsArray *mazePointsArray, Map *map, Point startPoint) {
+static enum MazeStatus verifyShortestPaths(Map *map, MazePointsArray *graph, int row, int col, const char *label, VerifyCounters *counters) {
+    int expected;
+    enum MazeStatus status = bfsShortestLength(map, row, col, &expected);
+    if (status != MAZE_OK)
+        return status;
+
+    int bfsLength;
+    char *printed = NULL;
+    size_t printedSize;
+    FILE *output = open_memstream(&printed, &printedSize);
+    if (output == NULL)
+        return MAZE_ERROR_MEMORY;
+    status = findShortestPathBfs(map, (Point){row, col}, &bfsLength, output);
+    fclose(output);
+    if (status == MAZE_OK && bfsLength != expected)
+        reportMismatch(counters, label, row, col, "findShortestPathBfs", expected, bfsLength);
+    if (status == MAZE_OK && bfsLength != -1 && !checkPrintedPath(map, row, col, printed, bfsLength))
+        reportMismatch(counters, label, row, col, "findShortestPathBfs, valid path", 1, 0);
+    int expectedExit = printedExitPosition(map, printed);
+    free(printed);
+    if (status != MAZE_OK)
+        return status;
+
+    // the start of the maze, as the --shortest modes see it
+    MazePointsArray mazePointsArray;
+    status = simplifyMaze(map, row, col, false, NULL, &mazePointsArray);
+    if (status != MAZE_OK)
+        return status;
+    long long length;
+    status = findshortesPath(&mazePointsArray, map, (Point){row, col}, &length, NULL);
+    freeMazePointsArray(&mazePointsArray);
+    if (status != MAZE_OK)
+        return status;
+    if (length != expected)
+        reportMismatch(counters, label, row, col, "simplifyMaze + a*", expected, length);
+
+    MazePointsArray selected;
+    status = selectReachableGraph(graph, map, row, col, &selected);
+    if (status != MAZE_OK)
+        return status;
+    ResultPathArray path = {NULL, -1};
+    status = findshortesPath(&selected, map, (Point){row, col}, &length, &path);
+    if (status == MAZE_OK && length != expected)
+        reportMismatch(counters, label, row, col, "graph + a*", expected, length);
+    if (status == MAZE_OK && path.pathIdxesCount != -1) {
+        printed = NULL;
+        output = open_memstream(&printed, &printedSize);
+        if (output == NULL) {
+            status = MAZE_ERROR_MEMORY;
+        } else {
+            reconstructPath(&path, &selected, map, (Point){row, col}, output);
+            fclose(output);
+            if (!checkPrintedPath(map, row, col, printed, (int)length))
+                reportMismatch(counters, label, row, col, "reconstructPath, valid path", 1, 0);
+            // of the equally close exits both engines take the first one
+            int exit = printedExitPosition(map, printed);
+            if (exit != expectedExit)
+                reportMismatch(counters, label, row, col, "reconstructPath, exit border position", expectedExit, exit);
+        }
+        free(printed);
+    }
+    free(path.pathIdxes);
+    free(selected.mazePoints); // the moves belong to the graph
+    if (status != MAZE_OK)
+        return status;
+
+    GraphRoutesArray routes;
+    status = findKShortestRoutes(graph, map, (Point){row, col}, 1, &routes);
+    if (status != MAZE_OK)
+        return status;
+    length = routes.routesCount == 0 ? -1 : routes.routes[0].length;
+    freeGraphRoutesArray(&routes);
+    if (length != expected)
+        reportMismatch(counters, label, row, col, "k shortest routes", expected, length);
+
+    Point foundExit;
+    status = simplifyMaze(map, row, col, false, &foundExit, &mazePointsArray);
+    if (status != MAZE_OK)
+        return status;
+    freeMazePointsArray(&mazePointsArray);
+    if ((foundExit.row != -1) != (expected != -1))
+        reportMismatch(counters, label, row, col, "reachable", expected != -1, foundExit.row != -1);
+    return MAZE_OK;
+}
 
-    EntryPointsArray entryPointsArray = findEntryPoints(map);
-    EntryPoint currentPoint;
-    ResultPathArray currentShortestPath;
-    ResultPathArray shortestPath = {NULL, -1};
+/**
+ * @brief - runs every engine from every entry point of the maze and compares them with the references
+ * @param - Map struct, valid maze
+ * @param - const char* label, the maze in the reported mismatches
+ * @param - VerifyCounters* counters
+ * @return - enum MazeStatus, MAZE_ERROR_MEMORY on error
+ */
+static enum MazeStatus verifyMaze(Map *map, const char *label, VerifyCounters *counters) {
+    EntryPointsArray entryPointsArray;
+    enum MazeStatus status = findEntryPoints(map, &entryPointsArray);
+    if (status != MAZE_OK)
+        return status;
+    MazePointsArray graph;
+    status = buildMazeGraph(map, false, &graph);
+    if (status != MAZE_OK)
+        return status;
+    counters->mazes++;
+
+    for (int i = 0; i < entryPointsArray.entryPointsCount && status == MAZE_OK; i++) {
+        EntryPoint entry = entryPointsArray.entryPoints[i];
+        if (i > 0 && entry.row == entryPointsArray.entryPoints[i-1].row && entry.col == entryPointsArray.entryPoints[i-1].col)
+            continue; // a corner cell can be entered throw two faces
+        counters->entryPoints++;
+        status = verifyWalks(map, entry.row, entry.col, label, counters);
+        if (status == MAZE_OK)
+            status = verifyShortestPaths(map, &graph, entry.row, entry.col, label, counters);
+    }
+    freeMazePointsArray(&graph);
+    return status;
+}
 
-    int mindistance = 0;
-    int currentDistance;
+#ifndef MAZE_LIBRARY
 
-    // go throw all the entry point, exit point combination, and run the a* algorithem
-    for (int i = 0; i < entryPointsArray.entryPointsCount; i++) {
-        currentPoint = entryPointsArray.entryPoints[i];
+/**
+ * @brief - opens random faces of the border cells, so the maze has more entry points
+ * @param - Map struct
+ * @param - unsigned long long* seed
+ * @param - int count, number of the tries
+ * @return - void
+ */
+static void carveBorderOpenings(Map *map, unsigned long long *seed, int count) {
+    for (int i = 0; i < count; i++) {
+        int row = nextRandom(seed) % map->rows + 1;
+        int col = nextRandom(seed) % map->cols + 1;
+        enum Sides side = nextRandom(seed) % 3;
+        int outRow = row;
+        int outCol = col;
+        enum Sides outSide = side;
+        moveDirection(&outRow, &outCol, &outSide);
+        if (getCell(map, outRow, outCol) == '?')
+            carveWall(map, row, col, side);
+    }
+}
 
-        if (currentPoint.row == startPoint.row && currentPoint.col == startPoint.col) // skip start == end ..
-            continue;
+/**
+ * @brief - verifies the engines on generated mazes of every kind
+ * @param - long mazesCount
+ * @param - enum CellLayout layout, of the cells
+ * @return - int, exit code, 1 if any engine differs from the references
+ * @note - the mazes are up to 20 x 20 cells, with random openings in the border, every mismatch is printed
+ */
+static int run_verify(long mazesCount, enum CellLayout layout) {
+    VerifyCounters counters = {0, 0, 0};
+    unsigned long long sizeSeed = 0x2545F4914F6CDD1DULL;
+    char label[64];
+
+    for (long i = 0; i < mazesCount; i++) {
+        enum MazeKind kind = i % 4;
+        int rows = nextRandom(&sizeSeed) % 20 + 1;
+        int cols = nextRandom(&sizeSeed) % 19 + 2;
+        unsigned long long seed = i + 1;
+        Map map = generateMaze(rows, cols, kind, seed, layout);
+        if (map.cells == NULL) {
+            fprintf(stderr, "%s\n", mazeStatusMessage(MAZE_ERROR_MEMORY));
+            return 1;
+        }
+        carveBorderOpenings(&map, &seed, 4);
+        snprintf(label, sizeof(label), "%s %dx%d seed %ld", mazeKindNames[kind], rows, cols, i + 1);
+        enum MazeStatus status = verifyMaze(&map, label, &counters);
+        freeMap(map);
+        if (status != MAZE_OK) {
+            fprintf(stderr, "%s\n", mazeStatusMessage(status));
+            return 1;
+        }
+    }
+    printf("{\"mazes\":%ld,\"entryPoints\":%ld,\"mismatches\":%ld}\n", counters.mazes, counters.entryPoints, counters.mismatches);
+    return counters.mismatches == 0 ? 0 : 1;
+}
 
-        Point endPoint = {currentPoint.row, currentPoint.col};
-        currentDistance = 0;
-        runAstar(startPoint, endPoint, mazePointsArray, &currentDistance, &currentShortestPath);
+#endif // MAZE_LIBRARY
 
-        if (currentShortestPath.pathIdxesCount == -1 || currentShortestPath.pathIdxes == NULL) // no result form a*
-            continue;
+#endif // !MAZE_LIBRARY || MAZE_FUZZ
 
-        if (currentDistance < mindistance || mindistance == 0) { //in case the path is shorter than the previous one, save it
-            mindistance = currentDistance;
-            shortestPath.pathIdxes = currentShortestPath.pathIdxes;
-            shortestPath.pathIdxesCount = currentShortestPath.pathIdxesCount;
-        } else {
-            free(currentShortestPath.pathIdxes);
+#ifdef MAZE_FUZZ
+/**
+ * @brief - libFuzzer entry point, loads the input as a maze and walks it, small valid mazes are verified as well
+ * @param - const unsigned char* data
+ * @param - size_t size
+ * @return - int, always 0
+ * @note - clang -std=c11 -g -O1 -pthread -fsanitize=fuzzer,address,undefined -DMAZE_LIBRARY -DMAZE_FUZZ maze.c
+ */
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size) {
+    if (size == 0)
+        return 0;
+    FILE *file = fmemopen((void *)data, size, "r");
+    if (file == NULL)
+        return 0;
+    Map map;
+    enum MazeStatus status = loadMazeStream(file, &map, LAYOUT_AUTO);
+    fclose(file);
+    if (status != MAZE_OK)
+        return 0;
+    EntryPointsArray entryPointsArray;
+    if ((long)map.rows * map.cols <= 1024 && findEntryPoints(&map, &entryPointsArray) == MAZE_OK) {
+        // the walks have to end also on invalid mazes
+        for (int i = 0; i < entryPointsArray.entryPointsCount; i++) {
+            solve_maze(&map, 0, entryPointsArray.entryPoints[i].row, entryPointsArray.entryPoints[i].col, NULL);
+            solve_maze(&map, 1, entryPointsArray.entryPoints[i].row, entryPointsArray.entryPoints[i].col, NULL);
         }
-   }
-   freeEntryPointsArray(&entryPointsArray);
-   return shortestPath;
+    }
+    if ((long)map.rows * map.cols <= 1024 && checkMazeValidity(map)) {
+        VerifyCounters counters = {0, 0, 0};
+        verifyMaze(&map, "fuzz input", &counters);
+        if (counters.mismatches != 0)
+            abort();
+    }
+    freeMap(map);
+    return 0;
 }
+#endif // MAZE_FUZZ
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// COMMAND LINE INTERFACE (left out with -DMAZE_LIBRARY, like the generator, the rendering, the benchmark and the verification)
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAZE_LIBRARY
+
+static bool statsEnabled = false;
+static enum CellLayout cellLayout = LAYOUT_AUTO;
+static char *costsFileName = NULL; // --costs, loaded with every maze
+static enum ShortestEngine shortestEngine = ENGINE_AUTO;
 
 /**
- * @brief - reconstructs the path form the shortest path array, after the a* algorithem
- * @param - ResultPathArray struct
- * @param - MazePointsArray struct
- * @param - Point startPoint
+ * @brief - prints the timing of the phases and the counters as json to the stderr
+ * @param - BenchPhase* phases
+ * @param - int phasesCount
  * @return - void
+ * @note - does nothing, unless --stats was given, only the allocation counters are reported without -DMAZE_STATS
  */
-void reconstructPath(ResultPathArray *shortestPath, MazePointsArray *mazePointArray, Point StartPoint) {
+static void printStats(BenchPhase *phases, int phasesCount) {
+    if (!statsEnabled)
+        return;
+    fprintf(stderr, "{\"phases\":{");
+    for (int i = 0; i < phasesCount; i++) {
+        fprintf(stderr, "%s\"%s\":{\"seconds\":%.9f,\"allocations\":%lu,\"reallocations\":%lu}",
+            i == 0 ? "" : ",", phases[i].name, phases[i].seconds, phases[i].allocations, phases[i].reallocations);
+    }
+    fprintf(stderr, "},\"counters\":{\"allocations\":%lu,\"reallocations\":%lu",
+        allocationCounters.allocations, allocationCounters.reallocations);
+#ifdef MAZE_STATS
+    fprintf(stderr, ",\"cellsParsed\":%lu,\"decisionPoints\":%lu,\"corridorsTraced\":%lu"
+        ",\"astarPops\":%lu,\"astarPushes\":%lu,\"heuristicEvaluations\":%lu,\"conectionScans\":%lu",
+        statsCounters.cellsParsed, statsCounters.decisionPoints, statsCounters.corridorsTraced,
+        statsCounters.astarPops, statsCounters.astarPushes, statsCounters.heuristicEvaluations,
+        statsCounters.conectionScans);
+#endif
+    fprintf(stderr, "}}\n");
+}
 
-    int currentRow = StartPoint.row;
-    int currentCol = StartPoint.col;
-    int endRow, endCol;
-    enum Sides currentDir;
+/**
+ * @brief - prints the error message of the status to the stderr
+ * @param - enum MazeStatus status
+ * @return - int, exit code
+ */
+static int reportStatus(enum MazeStatus status) {
+    if (status == MAZE_OK)
+        return 0;
+    fprintf(stderr, "%s\n", mazeStatusMessage(status));
+    return 1;
+}
 
-    printf("%d,%d\n", currentRow, currentCol);
-    for (int i = shortestPath->pathIdxesCount-1; i >= 0; i--) {
-        endRow = mazePointArray->mazePoints[shortestPath->pathIdxes[i]].endPoint.row;
-        endCol = mazePointArray->mazePoints[shortestPath->pathIdxes[i]].endPoint.col;
-        for (int j = 0; j < mazePointArray->mazePoints[shortestPath->pathIdxes[i]].distance; j++) {
-            if (currentRow == endRow && currentCol == endCol) 
-                break;
-            currentDir = mazePointArray->mazePoints[shortestPath->pathIdxes[i]].moveThrowFaces[j];
-            moveDirection(&currentRow, &currentCol, &currentDir);
-            printf("%d,%d\n", currentRow, currentCol);
-        }
-    }   
+/**
+ * @brief - loads the maze (and the costs given by --costs), reports the error if it cannot be loaded
+ * @param - char file_name[]
+ * @param - Map* mapOfMaze
+ * @return - bool, whether the maze was loaded
+ * @note - a file, that does not contain a maze, is reported as Invalid also on the stdout
+ */
+static bool loadMazeFile(char file_name[], Map *mapOfMaze) {
+    enum MazeStatus status = loadMaze(file_name, mapOfMaze, cellLayout);
+    if (status == MAZE_ERROR_FORMAT)
+        printf("Invalid\n");
+    if (status == MAZE_OK && costsFileName != NULL) {
+        status = loadCosts(costsFileName, mapOfMaze);
+        if (status != MAZE_OK)
+            freeMap(*mapOfMaze);
+    }
+    return reportStatus(status) == 0;
 }
 
 /**
@@ -934,38 +3443,62 @@ void reconstructPath(ResultPathArray *shortestPath, MazePointsArray *mazePointAr
  * @param - char* argv[]
  * @return - void
  */
-void help(char *argv[]) {
+static void help(char *argv[]) {
     printf("Usage: %s [options]\n", argv[0]);
     printf("Options:\n");
     printf("  --help: Display this help message\n");
     printf("  --test file.txt: Run a test with the specified maze file\n");
     printf("  --rpath R C file.txt: Find a right path in the maze\n");
     printf("  --lpath R C file.txt: Find a left path in the maze\n");
+    printf("  --all-paths left|right file.txt: Follow the wall from every entry point (in parallel)\n");
     printf("  --shortest R C file.txt: Find the shortest path in the maze\n");
+    printf("  --shortest-length R C file.txt: Print only the length of the shortest path\n");
+    printf("  --reachable R C file.txt: Print whether any exit can be reached\n");
+    printf("  --k-shortest K R C file.txt: Print the K shortest routes to any exit, separated by an empty line\n");
+    printf("  --render out.ppm|out.svg R C file.txt: Draw the maze with the right, the left and the shortest path\n");
+    printf("  --generate KIND R C [seed]: Print a generated maze (perfect, loops, open, serpentine)\n");
+    printf("  --bench [max_cells]: Benchmark the solver on generated mazes up to 10^7 cells, prints json lines\n");
+    printf("  --verify [mazes]: Compare every solver engine with the reference searches on generated mazes (default 1000)\n");
+    printf("  --stats: Put before other options, prints the timing of the phases as json to the stderr\n");
+    printf("           (the counters are only compiled in with -DMAZE_STATS)\n");
+    printf("  --layout row|tiled|auto: Put before other options, memory layout of the cells (default auto)\n");
+    printf("  --costs costs.txt: Put before other options, cost of entering every cell (0-255) for the shortest paths\n");
+    printf("  --engine bfs|graph|auto: Put before other options, engine of --shortest and --shortest-length (default auto)\n");
 }
 
 
 /**
  * @brief - test the maze file
  * @param - char file_name[]
- * @return - void
+ * @return - int, exit code
  */
-void test_file(char file_name[]) {
-    Map mapOfMaze = loadMaze(file_name);
+static int test_file(char file_name[]) {
+    BenchPhase phases[3];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
     //representMaze(mapOfMaze);
+    beginBenchPhase(&phases[1], "checkMazeValidity");
     bool mazeValid = checkMazeValidity(mapOfMaze);
+    endBenchPhase(&phases[1]);
     if (!mazeValid) {
         printf("Invalid\n");
-        return;
-    }
-    EntryPointsArray entryPointsArray = findEntryPoints(&mapOfMaze);
-    if (entryPointsArray.entryPointsCount == 0) {
-        printf("Invalid\n");
-        return;
+        printStats(phases, 2);
+        freeMap(mapOfMaze);
+        return 0;
     }
-    freeEntryPointsArray(&entryPointsArray);
+    beginBenchPhase(&phases[2], "findEntryPoints");
+    EntryPointsArray entryPointsArray;
+    enum MazeStatus status = findEntryPoints(&mapOfMaze, &entryPointsArray);
+    endBenchPhase(&phases[2]);
+    printStats(phases, 3);
     freeMap(mapOfMaze);
-    printf("Valid\n");
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printf(entryPointsArray.entryPointsCount == 0 ? "Invalid\n" : "Valid\n");
+    return 0;
 }
 
 
@@ -974,40 +3507,457 @@ void test_file(char file_name[]) {
  * @param - int R (row)
  * @param - int C (colunm)
  * @param - char file_name[]
+ * @return - int, exit code
+ */
+static int run_line_follow(int R, int C, char file_name[], int left_right) {
+    BenchPhase phases[2];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    beginBenchPhase(&phases[1], "solve_maze");
+    enum MazeStatus status = solve_maze(&mapOfMaze, left_right, R, C, stdout);
+    endBenchPhase(&phases[1]);
+    freeMap(mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printStats(phases, 2);
+    return 0;
+}
+
+
+/**
+ * @brief - runs the wall follower from every entry point, assigned to the thread
+ * @param - void* arg, FollowerThread struct
+ * @return - void* NULL
+ * @note - every path is printed to its own memory stream, so the threads do not share any output,
+ *         the thread stops at the first stream, that cannot be written, or walk, that does not end, and sets its status
+ */
+static void *runFollowerThread(void *arg) {
+    FollowerThread *thread = arg;
+    EntryPoint entry;
+    thread->status = MAZE_OK;
+
+    for (int i = thread->threadIdx; i < thread->entryPointsArray->entryPointsCount; i += thread->threadsCount) {
+        if (thread->sameEntryAs[i] != -1) // the same walk as of the previous entry point
+            continue;
+        entry = thread->entryPointsArray->entryPoints[i];
+        FILE *output = open_memstream(&thread->outputs[i], &thread->outputSizes[i]);
+        if (output == NULL) {
+            thread->status = MAZE_ERROR_MEMORY;
+            break;
+        }
+        fprintf(output, "%d,%d\n", entry.row, entry.col);
+        if (thread->leftRight == 0)
+            thread->status = followRightHand(thread->map, entry.row, entry.col, entry.entrySide, output, NULL);
+        else
+            thread->status = followLeftHand(thread->map, entry.row, entry.col, entry.entrySide, output, NULL);
+        if (fclose(output) != 0 && thread->status == MAZE_OK)
+            thread->status = MAZE_ERROR_MEMORY;
+        if (thread->status != MAZE_OK)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * @brief - runs the line follow algorithem from all the entry points at once
+ * @param - char* hand, left or right
+ * @param - char file_name[]
+ * @return - int, exit code
+ * @note - the paths are printed in the order of the entry points, separated by an empty line
  */
-void run_line_follow(int R, int C, char file_name[], int left_right) {
-    Map mapOfMaze = loadMaze(file_name);
-    solve_maze(&mapOfMaze, left_right, R, C);
+static int run_all_paths(char *hand, char file_name[]) {
+    int leftRight;
+    if (strcmp(hand, "right") == 0)
+        leftRight = 0;
+    else if (strcmp(hand, "left") == 0)
+        leftRight = 1;
+    else {
+        fprintf(stderr, "Error: the hand has to be left or right!\n");
+        return 1;
+    }
+
+    Map mapOfMaze;
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    EntryPointsArray entryPointsArray;
+    if (findEntryPoints(&mapOfMaze, &entryPointsArray) != MAZE_OK) {
+        freeMap(mapOfMaze);
+        return reportStatus(MAZE_ERROR_MEMORY);
+    }
+    int count = entryPointsArray.entryPointsCount;
+
+    int *sameEntryAs = mazeMalloc((count + 1) * sizeof(int));
+    char **outputs = mazeMalloc((count + 1) * sizeof(char *));
+    size_t *outputSizes = mazeMalloc((count + 1) * sizeof(size_t));
+    if (sameEntryAs == NULL || outputs == NULL || outputSizes == NULL) {
+        free(sameEntryAs);
+        free(outputs);
+        free(outputSizes);
+        freeMap(mapOfMaze);
+        return reportStatus(MAZE_ERROR_MEMORY);
+    }
+    // a corner cell can be listed twice, startBorder always uses the first entry side
+    for (int i = 0; i < count; i++) {
+        outputs[i] = NULL;
+        outputSizes[i] = 0;
+        sameEntryAs[i] = -1;
+        for (int j = 0; j < i && sameEntryAs[i] == -1; j++) {
+            if (entryPointsArray.entryPoints[j].row == entryPointsArray.entryPoints[i].row &&
+                entryPointsArray.entryPoints[j].col == entryPointsArray.entryPoints[i].col)
+                sameEntryAs[i] = j;
+        }
+    }
+
+    long threadsCount = sysconf(_SC_NPROCESSORS_ONLN);
+    threadsCount = threadsCount < 1 ? 1 : (threadsCount > count ? count : threadsCount);
+    threadsCount = threadsCount < 1 ? 1 : threadsCount;
+    pthread_t threads[threadsCount];
+    bool threadStarted[threadsCount];
+    FollowerThread threadArgs[threadsCount];
+
+    for (int t = 0; t < threadsCount; t++) {
+        threadArgs[t] = (FollowerThread){&mapOfMaze, &entryPointsArray, sameEntryAs, leftRight, t, (int)threadsCount, outputs, outputSizes, MAZE_OK};
+        threadStarted[t] = pthread_create(&threads[t], NULL, runFollowerThread, &threadArgs[t]) == 0;
+        if (!threadStarted[t]) // run the walks in this thread instead
+            runFollowerThread(&threadArgs[t]);
+    }
+    enum MazeStatus status = MAZE_OK;
+    for (int t = 0; t < threadsCount; t++) {
+        if (threadStarted[t])
+            pthread_join(threads[t], NULL);
+        if (threadArgs[t].status != MAZE_OK)
+            status = threadArgs[t].status;
+    }
+
+    for (int i = 0; i < count && status == MAZE_OK; i++) {
+        int source = sameEntryAs[i] == -1 ? i : sameEntryAs[i];
+        if (i != 0)
+            printf("\n");
+        if (outputs[source] != NULL)
+            fwrite(outputs[source], 1, outputSizes[source], stdout);
+    }
+    for (int i = 0; i < count; i++)
+        free(outputs[i]);
+    free(outputs);
+    free(outputSizes);
+    free(sameEntryAs);
     freeMap(mapOfMaze);
+    return reportStatus(status);
+}
+
+/**
+ * @brief - builds the corridor graph and selects the corridors reachable from the entry point
+ * @param - Map* mapOfMaze
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - bool storeMoves
+ * @param - MazePointsArray* mazeGraph
+ * @param - MazePointsArray* mazePoinsArray, the selected corridors
+ * @param - BenchPhase phases[2]
+ * @return - enum MazeStatus, nothing is left allocated on error
+ */
+static enum MazeStatus loadReachableGraph(Map *mapOfMaze, int R, int C, bool storeMoves, MazePointsArray *mazeGraph, MazePointsArray *mazePoinsArray, BenchPhase phases[2]) {
+    beginBenchPhase(&phases[0], "buildMazeGraph");
+    enum MazeStatus status = buildMazeGraph(mapOfMaze, storeMoves, mazeGraph);
+    endBenchPhase(&phases[0]);
+    if (status != MAZE_OK)
+        return status;
+    beginBenchPhase(&phases[1], "selectReachableGraph");
+    status = selectReachableGraph(mazeGraph, mapOfMaze, R, C, mazePoinsArray);
+    endBenchPhase(&phases[1]);
+    if (status != MAZE_OK)
+        freeMazePointsArray(mazeGraph);
+    return status;
 }
 
+/**
+ * @brief - finds the shortest path cell by cell, for --shortest and --shortest-length
+ * @param - Map* mapOfMaze, loaded maze, it is freed
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - bool printPath, whether to print the path, or only its length
+ * @param - BenchPhase phases[2], the loadMaze phase is already measured
+ * @return - int, exit code
+ */
+static int run_shortest_bfs(Map *mapOfMaze, int R, int C, bool printPath, BenchPhase phases[2]) {
+    int shortestLength;
+    beginBenchPhase(&phases[1], "findShortestPathBfs");
+    enum MazeStatus status = findShortestPathBfs(mapOfMaze, (Point){R, C}, &shortestLength, printPath ? stdout : NULL);
+    endBenchPhase(&phases[1]);
+    freeMap(*mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    if (!printPath && shortestLength != -1)
+        printf("%d\n", shortestLength);
+    printStats(phases, 2);
+    return 0;
+}
 
 /**
  * @brief - finds the shortest path in the maze
  * @param - int R (row)
  * @param - int C (colunm)
  * @param - char file_name[]
- * @return - void
+ * @return - int, exit code
+ * @note - small or open maps are searched cell by cell, the others throw the graph of the corridors
  */
-void find_shortest_path(int R, int C, char file_name[]) {
-    Map mapOfMaze = loadMaze(file_name);
-    MazePointsArray mazePoinsArray = simplifyMaze(&mapOfMaze, R, C);
-    if (mazePoinsArray.mazePointsCount == 1) {
-        printf("%d,%d\n", R, C);
-        freeMazePointsArray(&mazePoinsArray);
+static int find_shortest_path(int R, int C, char file_name[]) {
+    BenchPhase phases[5];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    if (chooseShortestEngine(&mapOfMaze, shortestEngine) == ENGINE_BFS)
+        return run_shortest_bfs(&mapOfMaze, R, C, true, phases);
+    MazePointsArray mazeGraph, mazePoinsArray;
+    // the moves are walked again in reconstructPath
+    enum MazeStatus status = loadReachableGraph(&mapOfMaze, R, C, false, &mazeGraph, &mazePoinsArray, &phases[1]);
+    if (status != MAZE_OK) {
         freeMap(mapOfMaze);
-        return;
+        return reportStatus(status);
     }
-    ResultPathArray shortesPath = findshortesPath(&mazePoinsArray, &mapOfMaze, (Point){R, C});
-    if (shortesPath.pathIdxesCount == -1) {
-        freeMazePointsArray(&mazePoinsArray);
+    beginBenchPhase(&phases[3], "findshortesPath");
+    long long shortestLength;
+    ResultPathArray shortesPath;
+    status = findshortesPath(&mazePoinsArray, &mapOfMaze, (Point){R, C}, &shortestLength, &shortesPath);
+    endBenchPhase(&phases[3]);
+    if (status != MAZE_OK || shortesPath.pathIdxesCount == -1) {
+        free(mazePoinsArray.mazePoints);
+        freeMazePointsArray(&mazeGraph);
         freeMap(mapOfMaze);
-        return;
+        if (status != MAZE_OK)
+            return reportStatus(status);
+        printStats(phases, 4);
+        return 0;
     }
-    reconstructPath(&shortesPath, &mazePoinsArray, (Point){R, C});
+    beginBenchPhase(&phases[4], "reconstructPath");
+    reconstructPath(&shortesPath, &mazePoinsArray, &mapOfMaze, (Point){R, C}, stdout);
+    endBenchPhase(&phases[4]);
+    printStats(phases, 5);
     free(shortesPath.pathIdxes);
+    free(mazePoinsArray.mazePoints); // the moves belong to the graph
+    freeMazePointsArray(&mazeGraph);
+    freeMap(mapOfMaze);
+    return 0;
+}
+
+/**
+ * @brief - prints the length of the shortest path in the maze (number of the cells on the path, or its cost with --costs)
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - char file_name[]
+ * @return - int, exit code
+ * @note - the corridors are traced without storing the moves, and the path is never reconstructed
+ */
+static int find_shortest_length(int R, int C, char file_name[]) {
+    BenchPhase phases[4];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    if (chooseShortestEngine(&mapOfMaze, shortestEngine) == ENGINE_BFS)
+        return run_shortest_bfs(&mapOfMaze, R, C, false, phases);
+    MazePointsArray mazeGraph, mazePoinsArray;
+    enum MazeStatus status = loadReachableGraph(&mapOfMaze, R, C, false, &mazeGraph, &mazePoinsArray, &phases[1]);
+    if (status != MAZE_OK) {
+        freeMap(mapOfMaze);
+        return reportStatus(status);
+    }
+    long long shortestLength;
+    beginBenchPhase(&phases[3], "findshortesPath");
+    status = findshortesPath(&mazePoinsArray, &mapOfMaze, (Point){R, C}, &shortestLength, NULL);
+    endBenchPhase(&phases[3]);
+    if (status == MAZE_OK && shortestLength != -1)
+        printf("%lld\n", shortestLength);
+    free(mazePoinsArray.mazePoints);
+    freeMazePointsArray(&mazeGraph);
+    freeMap(mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printStats(phases, 4);
+    return 0;
+}
+
+/**
+ * @brief - prints the k shortest routes from the entry point to any exit
+ * @param - int K (number of the routes)
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - char file_name[]
+ * @return - int, exit code
+ * @note - the routes are printed from the shortest one, separated by an empty line
+ */
+static int find_k_shortest_paths(int K, int R, int C, char file_name[]) {
+    if (K < 1) {
+        fprintf(stderr, "Error: K has to be at least 1!\n");
+        return 1;
+    }
+    BenchPhase phases[4];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    beginBenchPhase(&phases[1], "buildMazeGraph");
+    MazePointsArray mazeGraph;
+    enum MazeStatus status = buildMazeGraph(&mapOfMaze, false, &mazeGraph);
+    endBenchPhase(&phases[1]);
+    GraphRoutesArray routes = {NULL, 0};
+    if (status == MAZE_OK) {
+        beginBenchPhase(&phases[2], "findKShortestRoutes");
+        status = findKShortestRoutes(&mazeGraph, &mapOfMaze, (Point){R, C}, K, &routes);
+        endBenchPhase(&phases[2]);
+        beginBenchPhase(&phases[3], "reconstructPath");
+        for (int i = 0; i < routes.routesCount; i++) {
+            if (i != 0)
+                printf("\n");
+            reconstructPath(&routes.routes[i].path, &mazeGraph, &mapOfMaze, (Point){R, C}, stdout);
+        }
+        endBenchPhase(&phases[3]);
+        freeGraphRoutesArray(&routes);
+        freeMazePointsArray(&mazeGraph);
+    }
+    freeMap(mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printStats(phases, 4);
+    return 0;
+}
+
+/**
+ * @brief - tests whether any exit can be reached from the entry point
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - char file_name[]
+ * @return - int, exit code
+ * @note - the simplification stops at the first corridor, that leads out of the maze
+ */
+static int find_reachable(int R, int C, char file_name[]) {
+    BenchPhase phases[2];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    beginBenchPhase(&phases[1], "simplifyMaze");
+    Point foundExit;
+    MazePointsArray mazePoinsArray;
+    enum MazeStatus status = simplifyMaze(&mapOfMaze, R, C, false, &foundExit, &mazePoinsArray);
+    endBenchPhase(&phases[1]);
+    freeMap(mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printf(foundExit.row != -1 ? "Reachable\n" : "Unreachable\n");
+    printStats(phases, 2);
     freeMazePointsArray(&mazePoinsArray);
+    return 0;
+}
+
+/**
+ * @brief - prints the path of the solver to the stream
+ * @param - Map struct
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - unsigned char mark, PATH_RPATH, PATH_LPATH or PATH_SHORTEST, the solver
+ * @param - FILE* output
+ * @return - enum MazeStatus, nothing is printed on error
+ * @note - the shortest path uses the engine of --shortest
+ */
+static enum MazeStatus printSolverPath(Map *mapOfMaze, int R, int C, unsigned char mark, FILE *output) {
+    if (mark != PATH_SHORTEST)
+        return solve_maze(mapOfMaze, mark == PATH_LPATH, R, C, output);
+    int cellsCount;
+    if (chooseShortestEngine(mapOfMaze, shortestEngine) == ENGINE_BFS)
+        return findShortestPathBfs(mapOfMaze, (Point){R, C}, &cellsCount, output);
+    long long shortestLength;
+    BenchPhase phases[2];
+    MazePointsArray mazeGraph, mazePoinsArray;
+    enum MazeStatus status = loadReachableGraph(mapOfMaze, R, C, false, &mazeGraph, &mazePoinsArray, phases);
+    if (status != MAZE_OK)
+        return status;
+    ResultPathArray shortesPath;
+    status = findshortesPath(&mazePoinsArray, mapOfMaze, (Point){R, C}, &shortestLength, &shortesPath);
+    if (status == MAZE_OK && shortesPath.pathIdxesCount != -1)
+        reconstructPath(&shortesPath, &mazePoinsArray, mapOfMaze, (Point){R, C}, output);
+    if (status == MAZE_OK)
+        free(shortesPath.pathIdxes);
+    free(mazePoinsArray.mazePoints); // the moves belong to the graph
+    freeMazePointsArray(&mazeGraph);
+    return status;
+}
+
+/**
+ * @brief - renders the maze with the right hand, the left hand and the shortest path from the entry point
+ * @param - char* imageName, .ppm or .svg
+ * @param - int R (row)
+ * @param - int C (colunm)
+ * @param - char file_name[]
+ * @return - int, exit code
+ * @note - the paths are printed to temporary files and only their cells are marked (one byte per cell)
+ */
+static int run_render(char *imageName, int R, int C, char file_name[]) {
+    size_t nameLength = strlen(imageName);
+    enum RenderFormat format;
+    if (nameLength > 4 && strcmp(imageName + nameLength - 4, ".ppm") == 0)
+        format = RENDER_PPM;
+    else if (nameLength > 4 && strcmp(imageName + nameLength - 4, ".svg") == 0)
+        format = RENDER_SVG;
+    else {
+        fprintf(stderr, "Error: the image has to be a .ppm or an .svg file!\n");
+        return 1;
+    }
+
+    BenchPhase phases[3];
+    Map mapOfMaze;
+    beginBenchPhase(&phases[0], "loadMaze");
+    if (!loadMazeFile(file_name, &mapOfMaze))
+        return 1;
+    endBenchPhase(&phases[0]);
+    unsigned char *marks = mazeMalloc(cellsSize(&mapOfMaze) + 1);
+    if (marks == NULL) {
+        freeMap(mapOfMaze);
+        return reportStatus(MAZE_ERROR_MEMORY);
+    }
+    memset(marks, 0, cellsSize(&mapOfMaze) + 1);
+
+    beginBenchPhase(&phases[1], "printSolverPath");
+    enum MazeStatus status = MAZE_OK;
+    const unsigned char solvers[3] = {PATH_RPATH, PATH_LPATH, PATH_SHORTEST};
+    for (int i = 0; i < 3 && status == MAZE_OK; i++) {
+        FILE *path = tmpfile();
+        if (path == NULL) {
+            status = MAZE_ERROR_FILE;
+            break;
+        }
+        status = printSolverPath(&mapOfMaze, R, C, solvers[i], path);
+        rewind(path);
+        if (status == MAZE_OK)
+            markPathCells(&mapOfMaze, path, solvers[i], marks);
+        fclose(path);
+    }
+    endBenchPhase(&phases[1]);
+
+    FILE *image = status == MAZE_OK ? fopen(imageName, "wb") : NULL;
+    if (status == MAZE_OK && image == NULL)
+        status = MAZE_ERROR_FILE;
+    if (status == MAZE_OK) {
+        beginBenchPhase(&phases[2], "renderMaze");
+        status = renderMaze(&mapOfMaze, marks, format, image);
+        endBenchPhase(&phases[2]);
+        if (fclose(image) != 0 && status == MAZE_OK)
+            status = MAZE_ERROR_FILE;
+    }
+    free(marks);
     freeMap(mapOfMaze);
+    if (status != MAZE_OK)
+        return reportStatus(status);
+    printStats(phases, 3);
+    return 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -1018,6 +3968,47 @@ void find_shortest_path(int R, int C, char file_name[]) {
  * @brief - main function
  */
 int main(int argc, char *argv[]) {
+    while (argc >= 2 && (strcmp(argv[1], "--stats") == 0 || strcmp(argv[1], "--layout") == 0 || strcmp(argv[1], "--costs") == 0 ||
+        strcmp(argv[1], "--engine") == 0)) {
+        int optionArgs = 1;
+        if (strcmp(argv[1], "--stats") == 0) {
+            statsEnabled = true;
+            allocationCounters.enabled = true;
+        } else if (strcmp(argv[1], "--engine") == 0) {
+            if (argc >= 3 && strcmp(argv[2], "bfs") == 0) {
+                shortestEngine = ENGINE_BFS;
+            } else if (argc >= 3 && strcmp(argv[2], "graph") == 0) {
+                shortestEngine = ENGINE_GRAPH;
+            } else if (argc >= 3 && strcmp(argv[2], "auto") == 0) {
+                shortestEngine = ENGINE_AUTO;
+            } else {
+                printf("Error: Invalid command-line arguments. Use './maze --help' for usage information.\n");
+                return 1;
+            }
+            optionArgs = 2;
+        } else if (strcmp(argv[1], "--costs") == 0 && argc >= 3) {
+            costsFileName = argv[2];
+            optionArgs = 2;
+        } else if (strcmp(argv[1], "--costs") == 0) {
+            printf("Error: Invalid command-line arguments. Use './maze --help' for usage information.\n");
+            return 1;
+        } else if (argc >= 3 && strcmp(argv[2], "row") == 0) {
+            cellLayout = LAYOUT_ROW_MAJOR;
+            optionArgs = 2;
+        } else if (argc >= 3 && strcmp(argv[2], "tiled") == 0) {
+            cellLayout = LAYOUT_TILED;
+            optionArgs = 2;
+        } else if (argc >= 3 && strcmp(argv[2], "auto") == 0) {
+            cellLayout = LAYOUT_AUTO;
+            optionArgs = 2;
+        } else {
+            printf("Error: Invalid command-line arguments. Use './maze --help' for usage information.\n");
+            return 1;
+        }
+        argv[optionArgs] = argv[0]; // drop the option, the program name is used by the help
+        argv += optionArgs;
+        argc -= optionArgs;
+    }
     if (argc < 2) {
         printf("Error: Insufficient arguments. Use './maze --help' for usage information.\n");
         return 1;
@@ -1025,16 +4016,34 @@ int main(int argc, char *argv[]) {
     if (strcmp(argv[1], "--help") == 0) 
         help(argv);
     else if (strcmp(argv[1], "--test") == 0 && argc == 3) 
-        test_file(argv[2]);
+        return test_file(argv[2]);
     else if (strcmp(argv[1], "--rpath") == 0 && argc == 5) 
-       run_line_follow(atoi(argv[2]), atoi(argv[3]), argv[4], 0);
+       return run_line_follow(atoi(argv[2]), atoi(argv[3]), argv[4], 0);
     else if (strcmp(argv[1], "--lpath") == 0 && argc == 5) 
-        run_line_follow(atoi(argv[2]), atoi(argv[3]), argv[4], 1);
+        return run_line_follow(atoi(argv[2]), atoi(argv[3]), argv[4], 1);
+    else if (strcmp(argv[1], "--all-paths") == 0 && argc == 4) 
+        return run_all_paths(argv[2], argv[3]);
     else if (strcmp(argv[1], "--shortest") == 0 && argc == 5) 
-        find_shortest_path(atoi(argv[2]), atoi(argv[3]), argv[4]);
+        return find_shortest_path(atoi(argv[2]), atoi(argv[3]), argv[4]);
+    else if (strcmp(argv[1], "--shortest-length") == 0 && argc == 5) 
+        return find_shortest_length(atoi(argv[2]), atoi(argv[3]), argv[4]);
+    else if (strcmp(argv[1], "--reachable") == 0 && argc == 5) 
+        return find_reachable(atoi(argv[2]), atoi(argv[3]), argv[4]);
+    else if (strcmp(argv[1], "--k-shortest") == 0 && argc == 6) 
+        return find_k_shortest_paths(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), argv[5]);
+    else if (strcmp(argv[1], "--render") == 0 && argc == 6) 
+        return run_render(argv[2], atoi(argv[3]), atoi(argv[4]), argv[5]);
+    else if (strcmp(argv[1], "--generate") == 0 && (argc == 5 || argc == 6)) 
+        return run_generate(argv[2], atoi(argv[3]), atoi(argv[4]), argc == 6 ? strtoull(argv[5], NULL, 10) : 1);
+    else if (strcmp(argv[1], "--bench") == 0 && (argc == 2 || argc == 3)) 
+        run_bench(argc == 3 ? atol(argv[2]) : 10000, cellLayout);
+    else if (strcmp(argv[1], "--verify") == 0 && (argc == 2 || argc == 3)) 
+        return run_verify(argc == 3 ? atol(argv[2]) : 1000, cellLayout);
     else {
         printf("Error: Invalid command-line arguments. Use './maze --help' for usage information.\n");
         return 1;
     }
     return 0;
 }
+
+#endif // MAZE_LIBRARY
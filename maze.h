@@ -0,0 +1,151 @@
+/*
+maze_solver - library interface
+Note:
+The functions of maze.c, that are usable without the command line interface (maze.c compiled with -DMAZE_LIBRARY).
+They never exit the program, they return enum MazeStatus and store the results throw pointers.
+On error nothing is left allocated, mazeStatusMessage returns the text of the error.
+*/
+
+#ifndef MAZE_H
+#define MAZE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// ENUMS
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+enum Sides { // declare the directions
+    DIAGONAL_LEFT,
+    DIAGONAL_RIGHT,
+    STRAIGHT
+};
+
+enum CellLayout { // declare the layouts of the cells in the memory
+    LAYOUT_ROW_MAJOR,
+    LAYOUT_TILED, // tiles of 64 x 64 cells, one after another
+    LAYOUT_AUTO
+};
+
+enum ShortestEngine { // declare the engines of the shortest path
+    ENGINE_GRAPH, // a* over the graph of the corridors
+    ENGINE_BFS, // breadth first search over the cells
+    ENGINE_AUTO
+};
+
+enum MazeStatus { // declare the results of the library functions
+    MAZE_OK,
+    MAZE_ERROR_FILE, // the file cannot be opened
+    MAZE_ERROR_FORMAT, // the file does not contain a maze
+    MAZE_ERROR_MEMORY,
+    MAZE_ERROR_NOT_ENTRY, // the selected point is not an entry point
+    MAZE_ERROR_ENDLESS // the wall follower goes round a loop without the entry point, the maze is invalid
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// STRUCTURES
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Map, MazePoint, MazePointsArray, ResultPathArray, GraphRoute and GraphRoutesArray are filled and freed by maze.c,
+// they are NOT a stable interface: their members are internal and can change between versions (the cell encoding, the layout, the caches).
+// Callers pass them back to the functions and read only the members marked "stable" below, nothing is to be written.
+
+typedef struct {
+    int row;
+    int col;
+} Point;
+
+typedef struct {
+    int row;
+    int col;
+    enum Sides entrySide;
+} EntryPoint;
+
+typedef struct {
+    EntryPoint *entryPoints;
+    int entryPointsCount;
+} EntryPointsArray;
+
+typedef struct Perimeter Perimeter; // the cached entry points of the map, private to maze.c
+
+typedef struct {
+  int rows; // stable
+  int cols; // stable
+  unsigned char *cells;
+  enum CellLayout layout;
+  unsigned char *costs; // cost of entering every cell (the same layout as the cells), NULL if every cell costs 1
+  int minCost; // the lowest cost in the costs, scales the heuristic of the a* algorithem
+  Perimeter *perimeter; // the entry points, built by the first findEntryPoints, NULL until then
+} Map;
+
+typedef struct {
+    Point startPoint;
+    Point endPoint;
+    enum Sides currentDir;
+    int distance;
+    enum Sides *moveThrowFaces;
+    bool finished;
+    enum Sides firstDir;
+    bool leavesMap; // the corridor ends out of the map (an exit)
+    long long cost; // sum of the costs of the cells entered in the map (distance without the step out, if there are no costs)
+} MazePoint;
+
+typedef struct {
+    MazePoint *mazePoints;
+    int mazePointsCount; // stable
+} MazePointsArray;
+
+typedef struct {
+    int* pathIdxes;
+    int pathIdxesCount;
+}ResultPathArray;
+
+typedef struct {
+    ResultPathArray path; // corridors of the graph, the last one first (as reconstructPath takes them)
+    long long length; // stable, cost of the route (number of its cells, if there are no costs)
+    int deviation; // index of the first corridor (from the start), the route leaves its parent route at
+} GraphRoute;
+
+typedef struct {
+    GraphRoute *routes; // stable (the array, not the members of the routes other than the length)
+    int routesCount; // stable
+} GraphRoutesArray;
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// FUNCTIONS (documented in maze.c)
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// errors
+const char *mazeStatusMessage(enum MazeStatus status);
+
+// loading and validation, the layout is LAYOUT_AUTO unless the caller knows better
+enum MazeStatus loadMazeStream(FILE *file, Map *maze, enum CellLayout layout);
+enum MazeStatus loadMaze(char* filename, Map *maze, enum CellLayout layout);
+enum MazeStatus loadCosts(char* filename, Map *maze);
+void freeMap(Map mapOfMaze);
+bool checkMazeValidity(Map mapOfMaze);
+
+// entry points, the array is cached on the map and freed by freeMap,
+// the map can be shared by more threads once findEntryPoints was called on it
+enum MazeStatus findEntryPoints(Map *map, EntryPointsArray *entryArray);
+enum MazeStatus startBorder(Map *map, int row, int col, enum Sides *entrySide);
+
+// wall follower, leftright 0 is the right hand rule, 1 the left hand rule
+enum MazeStatus solve_maze(Map *mapOfMaze, int leftright, int row, int col, FILE *output);
+
+// graph of the corridors, freed by freeMazePointsArray
+enum MazeStatus simplifyMaze(Map *map, int startRow, int startCol, bool storeMoves, Point *foundExit, MazePointsArray *result);
+enum MazeStatus buildMazeGraph(Map *map, bool storeMoves, MazePointsArray *graph);
+enum MazeStatus selectReachableGraph(MazePointsArray *graph, Map *map, int startRow, int startCol, MazePointsArray *result);
+void freeMazePointsArray(MazePointsArray *array);
+
+// shortest paths, the engine is picked by chooseShortestEngine
+enum ShortestEngine chooseShortestEngine(Map *map, enum ShortestEngine engine);
+enum MazeStatus findshortesPath(MazePointsArray *mazePointsArray, Map *map, Point startPoint, long long *shortestLength, ResultPathArray *shortestPath);
+void reconstructPath(ResultPathArray *shortestPath, MazePointsArray *mazePointArray, Map *map, Point StartPoint, FILE *output);
+enum MazeStatus findShortestPathBfs(Map *map, Point startPoint, int *shortestLength, FILE *output);
+enum MazeStatus findKShortestRoutes(MazePointsArray *graph, Map *map, Point startPoint, int k, GraphRoutesArray *routes);
+void freeGraphRoutesArray(GraphRoutesArray *array);
+
+#endif // MAZE_H